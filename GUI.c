@@ -27,6 +27,10 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include "dfa_engine.h"
+#include "npda_frontier.h"
+#include "pda_engine.h"
+#include "pda_stack.h"
 #define PINK_BG "\033[48;5;218m"
 #define RESET "\033[0m"
 #define RED "\033[31m"
@@ -39,51 +43,21 @@
 
 #define MAX_VERTEX_BUFFER 512 * 1024
 #define MAX_ELEMENT_BUFFER 128 * 1024
-#define MAX_SIZE 1000
 #define MAX_STACK_SIZE 100
-#define MAX_CONFIGURATIONS 100 
 #define MAX_INPUT_SIZE 100
 
 // ========================= DFA IMPLEMENTATION =========================
 typedef enum {
     S0, // initial state
-    S1,
-    S2, // final state
+    S1, // accept state
+    S2, // sink state
 } State;
 
-State transation(State currentState, char input) {
-    // Error checking for invalid input
-    if (input != '0' && input != '1' ) {
-        return -1; // Invalid input
-    }
+// Transition table shared with dfa.c, built once in main()
+static Dfa dfa_machine;
 
-    switch (currentState) {
-// State S0 - Initial state for 0's and 1's       
-        case S0:
-            if (input == '0')
-                return S0;
-            else if (input == '1')
-                return S1;
-            break;
-
-// State S1 - Trap state for 0's transitionary for next state on input 1
-        case S1:
-            if (input == '0')
-                return S1; // Stay in S1
-            else if (input == '1')
-                return S2; // Transition to S2
-            break;
-
-// State S2 - Accept state for one [1]
-        case S2:
-            if (input == '0')
-                return S2; // Stay in S2
-            else if (input == '1')
-                return S2; // Stay in S2
-            break;
-    }
-                    
-    return currentState;
+State transation(State currentState, char input) {
+    return (State)dfaStep(&dfa_machine, (DfaState)currentState, (unsigned char)input);
 }
 
 int validateInput(const char* str) {
@@ -107,27 +81,27 @@ int processDFA(const char* input, char* result_text, size_t result_size) {
         return 0;
     }
     
-    if (strlen(input) == 0) {
+    size_t len = strlen(input);
+    if (len == 0) {
         snprintf(result_text, result_size, "REJECTED: Empty string (no 1s)");
         return 0;
     }
     
-    State currentState = S0;
-    
-    /* Process each character */
-    for (int i = 0; i < (int)strlen(input); i++) {
-        currentState = transation(currentState, input[i]);
-    }
+    /* Vectorized kernel, ends in the same state as the table walk and
+       stops at the second '1' */
+    size_t consumed;
+    State currentState = (State)dfaExactlyOneOneSimd(input, len, &consumed);
     
     /* Check final state */
-    if (currentState == S1) {
+    if (dfaIsAccepting(&dfa_machine, (DfaState)currentState)) {
         snprintf(result_text, result_size, "ACCEPTED: Contains exactly one '1'");
         return 1;
     } else if (currentState == S0) {
         snprintf(result_text, result_size, "REJECTED: Contains no '1's");
         return 0;
     } else {
-        snprintf(result_text, result_size, "REJECTED: Contains more than one '1'");
+        snprintf(result_text, result_size, "REJECTED: Contains more than one '1' (stopped after %zu of %zu characters)",
+            consumed, len);
         return 0;
     }
 }
@@ -140,109 +114,11 @@ typedef enum {
     PDA_S3   // reject  
 } PDA_State;
 
-typedef struct {
-    char *items;
-    int top;
-} PDA_Stack;
-
-void PDA_initStack(PDA_Stack *stack) {
-    stack->items = malloc(MAX_SIZE * sizeof(char));
-    if (!stack->items) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(1);
-    }
-    stack->top = -1;
-}
-
-void PDA_push(PDA_Stack *stack, char symbol) {
-    stack->items[++(stack->top)] = symbol;
-}
-
-char PDA_pop(PDA_Stack *stack) {
-    if (stack->top < 0) {
-        return '$'; // Return bottom marker instead of crashing
-    }
-    return stack->items[(stack->top)--];
-}
-
-char PDA_peek(PDA_Stack *stack) {
-    if (stack->top < 0)
-        return '$';  // treat empty as bottom marker
-    return stack->items[stack->top];
-}
-
-int PDA_isEmpty(PDA_Stack *stack) {
-    return stack->top == -1;
-}
-
-void PDA_freeStack(PDA_Stack *stack) {
-    if (stack->items) {
-        free(stack->items);
-        stack->items = NULL;
-    }
-    stack->top = -1;
-}
-
-PDA_State PDA_transition(PDA_State currentState, PDA_Stack *stack, char input) {
-    // Input validation first
-    if (input != '0' && input != '1') {
-        return PDA_S3; // Invalid input - reject
-    }
-    
-    switch (currentState) {
-        case PDA_S0:
-            // input: 0, stack_top: $ (empty) -> push 0, stay in S0
-            if (input == '0' && PDA_peek(stack) == '$') {
-                PDA_push(stack, '0');
-                return PDA_S0;
-            }
-            // input: 0, stack_top: 0 -> push 0, stay in S0
-            else if (input == '0' && PDA_peek(stack) == '0') {
-                PDA_push(stack, '0');
-                return PDA_S0;
-            }
-            // input: 1, stack_top: $ (empty) -> n=0, need exactly 1 one -> accept
-            else if (input == '1' && PDA_peek(stack) == '$') {
-                return PDA_S2; // Accept state (0⁰1¹)
-            }
-            // input: 1, stack_top: 0 -> start pop phase, pop 0, go to S1
-            else if (input == '1' && PDA_peek(stack) == '0') {
-                PDA_pop(stack);
-                return PDA_S1;
-            }
-            else {
-                return PDA_S3; // Reject
-            }
-
-        case PDA_S1:
-            // input: 0, stack_top: any -> ERROR! Can't have 0 after starting 1's
-            if (input == '0') {
-                return PDA_S3; // Reject - violates 0ⁿ1ⁿ⁺¹ pattern
-            }
-            // input: 1, stack_top: 0 -> pop 0, continue in S1
-            else if (input == '1' && PDA_peek(stack) == '0') {
-                PDA_pop(stack);
-                return PDA_S1;
-            }
-            // input: 1, stack_top: $ (empty) -> this is the extra 1, accept!
-            else if (input == '1' && PDA_peek(stack) == '$') {
-                return PDA_S2; // Accept state
-            }
-            else {
-                return PDA_S3; // Reject
-            }
-
-        case PDA_S2:
-            // Any input after reaching accept state should reject
-            return PDA_S3; // Reject - string should end at accept state
-
-        case PDA_S3:
-            return PDA_S3; // Stay in reject state
-
-        default:
-            return PDA_S3; // Unknown state -> reject
-    }
-}
+// Transition table shared with pda.c, built once in main(); states are numbered as above
+static Pda pda_machine;
+// Stack of every processPDA() call, cleared by pdaReset() rather than freed
+static char pda_stack_items[64];
+static Stack pda_stack;
 
 /* Process PDA string and return result */
 int processPDA(const char* input, char* result_text, size_t result_size) {
@@ -251,27 +127,26 @@ int processPDA(const char* input, char* result_text, size_t result_size) {
         return 0;
     }
     
-    PDA_State currentState = PDA_S0;
-    PDA_Stack stack;
-    PDA_initStack(&stack);
-    PDA_push(&stack, '$'); // Initialize with bottom marker
+    int currentState = pdaReset(&pda_machine, &pda_stack); // PDA_S0 over the '$' bottom marker
     
-    /* Process each character */
-    for (int i = 0; i < (int)strlen(input); i++) {
-        currentState = PDA_transition(currentState, &stack, input[i]);
-    }
+    /* Process each character, stopping once a sink settles the result */
+    size_t len = strlen(input);
+    size_t consumed = pdaRunUntilSink(&pda_machine, &currentState, &pda_stack, input, len);
     
     /* Check final state and stack condition */
     int result = 0;
-    if (currentState == PDA_S2 && PDA_peek(&stack) == '$') {
+    if (pdaIsAccepting(&pda_machine, currentState, &pda_stack)) {
         snprintf(result_text, result_size, "ACCEPTED: String is in language {0^n 1^(n+1)}");
         result = 1;
+    } else if (consumed < len) {
+        snprintf(result_text, result_size, "REJECTED: String is NOT in language {0^n 1^(n+1)} (stopped after %zu of %zu characters)",
+            consumed, len);
+        result = 0;
     } else {
         snprintf(result_text, result_size, "REJECTED: String is NOT in language {0^n 1^(n+1)}");
         result = 0;
     }
     
-    PDA_freeStack(&stack);
     return result;
 }
 
@@ -282,90 +157,37 @@ typedef enum {
     NPDA_S2, // accept state
 } NPDA_State;
 
-typedef struct {
-    char *items;
-    int top;
-} NPDA_Stack;
-
-typedef struct {
-    NPDA_State state;
-    NPDA_Stack stack;
-    int input_pos;
-} NPDA_Configuration;
-
-void NPDA_initStack(NPDA_Stack *stack) {
-    stack->items = malloc(MAX_SIZE * sizeof(char));
-    if (!stack->items) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(1);
-    }
-    stack->top = -1;
-}
-
-void NPDA_push(NPDA_Stack *stack, char symbol) {
-    stack->items[++(stack->top)] = symbol;
-}
-
-char NPDA_pop(NPDA_Stack *stack) {
-    if (stack->top < 0) {
-        return '$';
-    }
-    return stack->items[(stack->top)--];
-}
-
-char NPDA_peek(NPDA_Stack *stack) {
-    if (stack->top < 0)
-        return '$';
-    return stack->items[stack->top];
-}
-
-int NPDA_isEmpty(NPDA_Stack *stack) {
-    return stack->top == -1;
-}
-
-void NPDA_freeStack(NPDA_Stack *stack) {
-    if (stack->items) {
-        free(stack->items);
-        stack->items = NULL;
-    }
-}
-
-void NPDA_copyStack(const NPDA_Stack* src, NPDA_Stack* dest) {
-    NPDA_initStack(dest);
-    for (int i = 0; i <= src->top; i++) {
-        dest->items[i] = src->items[i];
-    }
-    dest->top = src->top;
-}
+typedef NpdaConfig NPDA_Configuration;
 
 int NPDA_transition(const char* input_string, int len) {
-    NPDA_Configuration current_configs[MAX_CONFIGURATIONS];
-    NPDA_Configuration next_configs[MAX_CONFIGURATIONS];
-
-    int num_current_configs = 1;
-    int num_next_configs = 0;
-
-    NPDA_initStack(&current_configs[0].stack);
-    current_configs[0].state = NPDA_S0;
-    current_configs[0].input_pos = 0;
+    NpdaFrontier current, next;
+    StackForest forest;
+    frontierInit(&current);
+    frontierInit(&next);
+    forestInit(&forest);
+
+    NPDA_Configuration *start = frontierAdd(&current);
+    start->state = NPDA_S0;
+    start->input_pos = 0;
+    start->stack = FOREST_EMPTY;
+    frontierCommit(&current);
     
     // Add epsilon transition to S1 from start
-    if (num_current_configs < MAX_CONFIGURATIONS) {
-        current_configs[num_current_configs].state = NPDA_S1;
-        NPDA_copyStack(&current_configs[0].stack, &current_configs[num_current_configs].stack);
-        current_configs[num_current_configs].input_pos = 0;
-        num_current_configs++;
-    }
+    start = frontierAdd(&current);
+    start->state = NPDA_S1;
+    start->input_pos = 0;
+    start->stack = FOREST_EMPTY;
+    frontierCommit(&current);
 
-    while (num_current_configs > 0) {
-        num_next_configs = 0;
+    while (current.count > 0) {
         int accepted = 0;
 
-        for (int i = 0; i < num_current_configs; i++) {
-            NPDA_Configuration conf = current_configs[i];
+        for (int i = 0; i < current.count; i++) {
+            NPDA_Configuration conf = current.configs[i];
+            NPDA_Configuration *succ;
             
             if (conf.input_pos == len) {
-                if (conf.state == NPDA_S1 && NPDA_isEmpty(&conf.stack)) {
+                if (conf.state == NPDA_S1 && conf.stack == FOREST_EMPTY) {
                     accepted = 1;
                 } 
                 continue;
@@ -375,60 +197,54 @@ int NPDA_transition(const char* input_string, int len) {
 
             if (conf.state == NPDA_S0) {
                 // Choice 1: Push
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-                    next_configs[num_next_configs].state = NPDA_S0;
-                    NPDA_copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    NPDA_push(&next_configs[num_next_configs].stack, c);
-                    next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                    num_next_configs++;
-                }
+                succ = frontierAdd(&next);
+                succ->state = NPDA_S0;
+                succ->stack = forestPush(&forest, conf.stack, c);
+                succ->input_pos = conf.input_pos + 1;
+                frontierCommit(&next);
 
                 // Choice 2: Skip (Odd Middle)
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-                    next_configs[num_next_configs].state = NPDA_S1;
-                    NPDA_copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                    num_next_configs++;
-                }
+                succ = frontierAdd(&next);
+                succ->state = NPDA_S1;
+                succ->stack = conf.stack;
+                succ->input_pos = conf.input_pos + 1;
+                frontierCommit(&next);
                 
                 // Choice 3: Epsilon-Jump (Even Middle)
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-                    next_configs[num_next_configs].state = NPDA_S1;
-                    NPDA_copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    next_configs[num_next_configs].input_pos = conf.input_pos;
-                    num_next_configs++;
-                }
+                succ = frontierAdd(&next);
+                succ->state = NPDA_S1;
+                succ->stack = conf.stack;
+                succ->input_pos = conf.input_pos;
+                frontierCommit(&next);
 
             } else if (conf.state == NPDA_S1) {
-                if (!NPDA_isEmpty(&conf.stack) && NPDA_peek(&conf.stack) == c) {
-                    if (num_next_configs < MAX_CONFIGURATIONS) {
-                        next_configs[num_next_configs].state = NPDA_S1;
-                        NPDA_copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                        NPDA_pop(&next_configs[num_next_configs].stack);
-                        next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                        num_next_configs++;
-                    }
+                if (conf.stack != FOREST_EMPTY && forestPeek(&forest, conf.stack) == c) {
+                    succ = frontierAdd(&next);
+                    succ->state = NPDA_S1;
+                    succ->stack = forestPop(&forest, conf.stack);
+                    succ->input_pos = conf.input_pos + 1;
+                    frontierCommit(&next);
                 }
             }
         }
 
-        for (int i = 0; i < num_current_configs; i++) {
-            NPDA_freeStack(&current_configs[i].stack);
-        }
+        frontierClear(&current);
         
         if (accepted) {
-            for (int i = 0; i < num_next_configs; i++) {
-                NPDA_freeStack(&next_configs[i].stack);
-            }
+            frontierFree(&current);
+            frontierFree(&next);
+            forestFree(&forest);
             return 1;
         }
 
-        num_current_configs = num_next_configs;
-        for (int i = 0; i < num_next_configs; i++) {
-            current_configs[i] = next_configs[i];
-        }
+        NpdaFrontier done = current;
+        current = next;
+        next = done;
     }
 
+    frontierFree(&current);
+    frontierFree(&next);
+    forestFree(&forest);
     return 0;
 }
 
@@ -526,6 +342,10 @@ int main() {
     static int npda_show_output = 0;
     static int npda_show_transition_table = 0;
     
+    dfaBuildExactlyOneOne(&dfa_machine);
+    pdaBuildZerosOnes(&pda_machine);
+    stackInit(&pda_stack, pda_stack_items, sizeof(pda_stack_items));
+
     glfwSetErrorCallback(error_callback);
     if (!glfwInit()) {
         printf("ERROR: Failed to initialize GLFW\n");
@@ -1012,5 +832,8 @@ int main() {
     nk_glfw3_shutdown(&glfw);
     glfwDestroyWindow(window);
     glfwTerminate();
+    dfaFree(&dfa_machine);
+    stackFree(&pda_stack);
+    pdaFree(&pda_machine);
     return 0;
 }
\ No newline at end of file
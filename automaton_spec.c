@@ -0,0 +1,699 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include "automaton_spec.h"
+
+#define MAX_LINE 1024
+#define MAX_TOKENS 64
+
+/*
+ * Split a line into whitespace-separated tokens, stopping at a comment
+ *
+ * @return Number of tokens, or -1 if there are more than MAX_TOKENS
+ */
+static int tokenize(char *line, char *tokens[]) {
+    int count = 0;
+    char *p = line;
+
+    for (;;) {
+        while (*p && isspace((unsigned char)*p))
+            p++;
+        if (*p == '\0' || *p == '#')
+            return count;
+        if (count == MAX_TOKENS)
+            return -1;
+        tokens[count++] = p;
+        while (*p && !isspace((unsigned char)*p))
+            p++;
+        if (*p)
+            *p++ = '\0';
+    }
+}
+
+static int findState(const AutomatonSpec *spec, const char *name) {
+    for (int i = 0; i < spec->num_states; i++) {
+        if (strcmp(spec->state_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool inSet(const char *set, int size, int c) {
+    return memchr(set, c, (size_t)size) != NULL;
+}
+
+static bool isStackSymbol(const AutomatonSpec *spec, int c) {
+    return c == spec->bottom || inSet(spec->stack_alphabet, spec->stack_size, c);
+}
+
+/*
+ * Parse a transition line
+ *
+ * @return NULL on success, otherwise a description of the problem
+ */
+static const char *parseTransition(AutomatonSpec *spec, char *tokens[], int count, SpecTransition *t) {
+    int arrow = spec->type == SPEC_DFA ? 2 : 3;
+
+    if (count <= arrow + 1 || strcmp(tokens[arrow], "->") != 0)
+        return spec->type == SPEC_DFA ? "expected 'STATE INPUT -> STATE'"
+                                      : "expected 'STATE INPUT TOP -> STATE [pop] [push SYMBOLS]'";
+
+    memset(t, 0, sizeof(*t));
+    if ((t->from = findState(spec, tokens[0])) < 0 || (t->to = findState(spec, tokens[arrow + 1])) < 0)
+        return "unknown state";
+
+    const char *input = tokens[1];
+    if (strcmp(input, "*") == 0)
+        t->input = SPEC_ANY;
+    else if (strcmp(input, "-") == 0 && spec->type == SPEC_NPDA)
+        t->input = SPEC_EPSILON;
+    else if (strlen(input) == 1 && inSet(spec->alphabet, spec->alphabet_size, (unsigned char)input[0]))
+        t->input = (unsigned char)input[0];
+    else
+        return "input is not an alphabet symbol";
+
+    t->top = SPEC_ANY;
+    if (spec->type != SPEC_DFA) {
+        const char *top = tokens[2];
+        if (strcmp(top, "*") == 0)
+            t->top = SPEC_ANY;
+        else if (strlen(top) == 1 && isStackSymbol(spec, (unsigned char)top[0]))
+            t->top = (unsigned char)top[0];
+        else
+            return "stack top is not a stack symbol";
+    }
+
+    for (int i = arrow + 2; i < count; i++) {
+        if (spec->type == SPEC_DFA)
+            return "a DFA transition takes no stack action";
+        if (strcmp(tokens[i], "pop") == 0) {
+            t->pop = true;
+        } else if (strcmp(tokens[i], "push") == 0 && i + 1 < count) {
+            const char *symbols = tokens[++i];
+            if (strlen(symbols) > SPEC_MAX_PUSH)
+                return "too many symbols pushed at once";
+            for (const char *c = symbols; *c; c++) {
+                if (!isStackSymbol(spec, (unsigned char)*c))
+                    return "pushed symbol is not a stack symbol";
+            }
+            strcpy(t->push, symbols);
+        } else {
+            return "expected 'pop' or 'push SYMBOLS'";
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Parse a list of one-character symbols into a set
+ *
+ * @return NULL on success, otherwise a description of the problem
+ */
+static const char *parseSymbols(char *tokens[], int count, char *set, int *size) {
+    *size = 0;
+    for (int i = 1; i < count; i++) {
+        if (strlen(tokens[i]) != 1)
+            return "symbols must be single characters";
+        if (strcmp(tokens[i], "*") == 0 || strcmp(tokens[i], "-") == 0)
+            return "'*' and '-' are reserved";
+        if (!inSet(set, *size, (unsigned char)tokens[i][0]))
+            set[(*size)++] = tokens[i][0];
+    }
+    return NULL;
+}
+
+/*
+ * Parse one directive or transition line
+ *
+ * @return NULL on success, otherwise a description of the problem
+ */
+static const char *parseLine(AutomatonSpec *spec, char *tokens[], int count, bool *have_type, int *capacity) {
+    const char *word = tokens[0];
+
+    if (strcmp(word, "type") == 0) {
+        if (count != 2)
+            return "expected 'type dfa|pda|npda'";
+        if (strcmp(tokens[1], "dfa") == 0)
+            spec->type = SPEC_DFA;
+        else if (strcmp(tokens[1], "pda") == 0)
+            spec->type = SPEC_PDA;
+        else if (strcmp(tokens[1], "npda") == 0)
+            spec->type = SPEC_NPDA;
+        else
+            return "unknown automaton type";
+        *have_type = true;
+        return NULL;
+    }
+    if (!*have_type)
+        return "the first directive must be 'type'";
+
+    if (strcmp(word, "states") == 0) {
+        for (int i = 1; i < count; i++) {
+            if (spec->num_states == SPEC_MAX_STATES)
+                return "too many states";
+            if (strlen(tokens[i]) >= SPEC_MAX_NAME)
+                return "state name too long";
+            if (findState(spec, tokens[i]) >= 0)
+                return "duplicate state";
+            strcpy(spec->state_names[spec->num_states++], tokens[i]);
+        }
+        return NULL;
+    }
+    if (strcmp(word, "alphabet") == 0)
+        return parseSymbols(tokens, count, spec->alphabet, &spec->alphabet_size);
+    if (strcmp(word, "stack") == 0)
+        return parseSymbols(tokens, count, spec->stack_alphabet, &spec->stack_size);
+    if (strcmp(word, "bottom") == 0) {
+        if (count != 2 || strlen(tokens[1]) != 1)
+            return "expected 'bottom SYMBOL'";
+        spec->bottom = (unsigned char)tokens[1][0];
+        return NULL;
+    }
+    if (strcmp(word, "start") == 0) {
+        if (count != 2 || (spec->start = findState(spec, tokens[1])) < 0)
+            return "expected 'start STATE' naming a declared state";
+        return NULL;
+    }
+    if (strcmp(word, "accept") == 0) {
+        for (int i = 1; i < count; i++) {
+            int s = findState(spec, tokens[i]);
+            if (s < 0)
+                return "unknown state";
+            spec->accepting[s] = true;
+        }
+        return NULL;
+    }
+    if (strcmp(word, "accept-stack") == 0) {
+        if (count == 2 && strcmp(tokens[1], "any") == 0)
+            spec->accept_stack = ACCEPT_STACK_ANY;
+        else if (count == 2 && strcmp(tokens[1], "bottom") == 0)
+            spec->accept_stack = ACCEPT_STACK_BOTTOM;
+        else if (count == 2 && strcmp(tokens[1], "empty") == 0)
+            spec->accept_stack = ACCEPT_STACK_EMPTY;
+        else
+            return "expected 'accept-stack any|bottom|empty'";
+        return NULL;
+    }
+
+    // Anything else is a transition
+    if (spec->num_transitions == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 16;
+        SpecTransition *grown = realloc(spec->transitions, (size_t)*capacity * sizeof(SpecTransition));
+        if (!grown) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        spec->transitions = grown;
+    }
+    const char *problem = parseTransition(spec, tokens, count, &spec->transitions[spec->num_transitions]);
+    if (!problem)
+        spec->num_transitions++;
+    return problem;
+}
+
+/*
+ * Find a cycle of epsilon moves that leaves the stack taller than it found it
+ *
+ * Followed round such a cycle, the moves push without end before another
+ * character is read, so a run would never finish. Each move is weighed by
+ * how much it can grow the stack, its pushes less one for a pop, and a
+ * cycle of positive weight is looked for with Bellman-Ford. A pop on the
+ * empty stack removes nothing, but the stack cannot keep coming back to
+ * empty on a path that grows it without end, so the weights hold for the
+ * part that matters. The check ignores stack tops, so it may refuse a
+ * cycle that could never be followed round.
+ *
+ * @param spec - The description
+ * @return Line of a move on such a cycle, or 0 if there is none
+ */
+static int findGrowingEpsilonCycle(const AutomatonSpec *spec) {
+    long height[SPEC_MAX_STATES] = { 0 };   // every state is a start
+    int via[SPEC_MAX_STATES];
+    int changed = -1;
+
+    for (int round = 0; round < spec->num_states; round++) {
+        changed = -1;
+        for (int k = 0; k < spec->num_transitions; k++) {
+            const SpecTransition *t = &spec->transitions[k];
+            if (t->input != SPEC_EPSILON)
+                continue;
+            long grown = height[t->from] + (long)strlen(t->push) - (t->pop ? 1 : 0);
+            if (grown > height[t->to]) {
+                height[t->to] = grown;
+                via[t->to] = k;
+                changed = t->to;
+            }
+        }
+        if (changed < 0)
+            return 0;
+    }
+
+    // Still growing after num_states rounds: walking back from the last
+    // state raised lands on the cycle
+    int s = changed;
+    for (int i = 0; i < spec->num_states; i++) {
+        s = spec->transitions[via[s]].from;
+    }
+    return spec->transitions[via[s]].line;
+}
+
+int specParse(AutomatonSpec *spec, const char *text, char *error, size_t error_size) {
+    memset(spec, 0, sizeof(*spec));
+    spec->start = -1;
+    spec->bottom = -1;
+    spec->accept_stack = ACCEPT_STACK_ANY;
+
+    bool have_type = false;
+    int capacity = 0;
+    int line_no = 0;
+    const char *p = text;
+
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+        char line[MAX_LINE];
+        char *tokens[MAX_TOKENS];
+        const char *problem = NULL;
+
+        line_no++;
+        if (len >= MAX_LINE) {
+            problem = "line too long";
+        } else {
+            memcpy(line, p, len);
+            line[len] = '\0';
+            int count = tokenize(line, tokens);
+            if (count < 0)
+                problem = "too many fields";
+            else if (count > 0) {
+                int before = spec->num_transitions;
+                problem = parseLine(spec, tokens, count, &have_type, &capacity);
+                if (!problem && spec->num_transitions > before)
+                    spec->transitions[spec->num_transitions - 1].line = line_no;
+            }
+        }
+        if (problem) {
+            snprintf(error, error_size, "line %d: %s", line_no, problem);
+            specFree(spec);
+            return -1;
+        }
+        p += len + (eol ? 1 : 0);
+    }
+
+    const char *problem = NULL;
+    if (!have_type)
+        problem = "missing 'type'";
+    else if (spec->num_states == 0)
+        problem = "missing 'states'";
+    else if (spec->start < 0)
+        problem = "missing 'start'";
+    else if (spec->alphabet_size == 0)
+        problem = "missing 'alphabet'";
+    else if (spec->accept_stack == ACCEPT_STACK_BOTTOM && spec->bottom < 0)
+        problem = "'accept-stack bottom' needs a 'bottom' marker";
+    if (problem) {
+        snprintf(error, error_size, "%s", problem);
+        specFree(spec);
+        return -1;
+    }
+
+    int cycle_line = findGrowingEpsilonCycle(spec);
+    if (cycle_line > 0) {
+        snprintf(error, error_size, "line %d: epsilon moves through here can push without end", cycle_line);
+        specFree(spec);
+        return -1;
+    }
+    return 0;
+}
+
+int specLoad(AutomatonSpec *spec, const char *path, char *error, size_t error_size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        snprintf(error, error_size, "cannot open %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    size_t size = 0, capacity = 4096;
+    char *text = malloc(capacity);
+    size_t n;
+    while (text && (n = fread(text + size, 1, capacity - size - 1, file)) > 0) {
+        size += n;
+        if (size + 1 == capacity) {
+            capacity *= 2;
+            char *grown = realloc(text, capacity);
+            if (!grown)
+                free(text);
+            text = grown;
+        }
+    }
+    fclose(file);
+    if (!text) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    text[size] = '\0';
+
+    char reason[256];
+    int result = specParse(spec, text, reason, sizeof(reason));
+    if (result != 0)
+        snprintf(error, error_size, "%s: %s", path, reason);
+    free(text);
+    return result;
+}
+
+void specFree(AutomatonSpec *spec) {
+    free(spec->transitions);
+    spec->transitions = NULL;
+    spec->num_transitions = 0;
+}
+
+int specBuildDfa(const AutomatonSpec *spec, Dfa *dfa, char *error, size_t error_size) {
+    if (spec->type != SPEC_DFA) {
+        snprintf(error, error_size, "not a DFA description");
+        return -1;
+    }
+
+    int n = spec->num_states;
+    int dead = n;
+    int *origin = calloc((size_t)n * DFA_SYMBOLS, sizeof(int)); // line that set each cell
+    if (!origin) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    dfaInit(dfa, n + 1, (DfaState)spec->start, (DfaState)dead);
+    for (int i = 0; i < spec->num_transitions; i++) {
+        const SpecTransition *t = &spec->transitions[i];
+        for (int a = 0; a < spec->alphabet_size; a++) {
+            unsigned char c = (unsigned char)spec->alphabet[a];
+            if (t->input != SPEC_ANY && t->input != c)
+                continue;
+            size_t cell = (size_t)t->from * DFA_SYMBOLS + c;
+            if (origin[cell] && dfa->next[cell] != t->to) {
+                snprintf(error, error_size, "line %d: conflicts with line %d on input '%c'",
+                    t->line, origin[cell], c);
+                free(origin);
+                dfaFree(dfa);
+                return -1;
+            }
+            origin[cell] = t->line;
+            dfaSetTransition(dfa, (DfaState)t->from, c, (DfaState)t->to);
+        }
+    }
+    for (int s = 0; s < n; s++) {
+        if (spec->accepting[s])
+            dfaSetAccept(dfa, (DfaState)s, true);
+    }
+
+    free(origin);
+    return 0;
+}
+
+int specBuildPda(const AutomatonSpec *spec, Pda *pda, char *error, size_t error_size) {
+    if (spec->type != SPEC_PDA) {
+        snprintf(error, error_size, "not a PDA description");
+        return -1;
+    }
+
+    // Stack columns: the bottom marker, the stack alphabet, then the empty stack
+    char symbols[257];
+    int num_symbols = 0;
+    if (spec->bottom >= 0)
+        symbols[num_symbols++] = (char)spec->bottom;
+    for (int i = 0; i < spec->stack_size; i++) {
+        if ((unsigned char)spec->stack_alphabet[i] != spec->bottom)
+            symbols[num_symbols++] = spec->stack_alphabet[i];
+    }
+
+    int n = spec->num_states;
+    int dead = n;
+    int num_tops = num_symbols + 1;
+    int *origin = calloc((size_t)n * num_tops * PDA_SYMBOLS, sizeof(int)); // line that set each cell
+    if (!origin) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    pdaInit(pda, n + 1, symbols, num_symbols, spec->start, dead);
+    pda->bottom = spec->bottom;
+    pda->accept_stack = spec->accept_stack;
+    for (int i = 0; i < spec->num_transitions; i++) {
+        const SpecTransition *t = &spec->transitions[i];
+        int action = pdaAction(pda, t->pop, t->push);
+        for (int top = 0; top < num_tops; top++) {
+            int symbol = top < num_symbols ? (unsigned char)symbols[top] : PDA_EMPTY_STACK;
+            if (t->top != SPEC_ANY && t->top != symbol)
+                continue;
+            for (int a = 0; a < spec->alphabet_size; a++) {
+                unsigned char c = (unsigned char)spec->alphabet[a];
+                if (t->input != SPEC_ANY && t->input != c)
+                    continue;
+                size_t cell = ((size_t)t->from * num_tops + top) * PDA_SYMBOLS + c;
+                const PdaMove *move = &pda->moves[cell];
+                if (origin[cell] && (move->next != t->to || move->action != action)) {
+                    snprintf(error, error_size, "line %d: conflicts with line %d on input '%c'",
+                        t->line, origin[cell], c);
+                    free(origin);
+                    pdaFree(pda);
+                    return -1;
+                }
+                origin[cell] = t->line;
+                pdaSetTransition(pda, t->from, symbol, c, t->to, action);
+            }
+        }
+    }
+    for (int s = 0; s < n; s++) {
+        pda->accept[s] = spec->accepting[s];
+    }
+
+    free(origin);
+    return 0;
+}
+
+// ---- Table printing ----
+
+/*
+ * Display width of a UTF-8 string (one column per code point)
+ */
+static int displayWidth(const char *text) {
+    int width = 0;
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if ((*p & 0xC0) != 0x80)
+            width++;
+    }
+    return width;
+}
+
+static void printRule(const int *widths, int columns, const char *left, const char *mid, const char *right) {
+    printf("%s", left);
+    for (int c = 0; c < columns; c++) {
+        for (int i = 0; i < widths[c]; i++) {
+            printf("─");
+        }
+        printf("%s", c == columns - 1 ? right : mid);
+    }
+    printf("\n");
+}
+
+/*
+ * Print one table row with every cell centred; a leading '*' hangs in the
+ * left margin so accept states line up with the others
+ */
+static void printRow(const int *widths, int columns, char cells[][64]) {
+    printf("│");
+    for (int c = 0; c < columns; c++) {
+        const char *text = cells[c];
+        bool marked = text[0] == '*' && text[1] != '\0';
+        if (marked)
+            text++;
+        int pad = widths[c] - displayWidth(text);
+        if (pad < 0)
+            pad = 0;
+        int left = pad / 2;
+        if (marked && left > 0)
+            printf("%*s*%s%*s│", left - 1, "", text, pad - left, "");
+        else
+            printf("%*s%s%s%*s│", left, "", marked ? "*" : "", text, pad - left, "");
+    }
+    printf("\n");
+}
+
+static void stateLabel(const AutomatonSpec *spec, int s, char *out) {
+    snprintf(out, 64, "%s%s", spec->accepting[s] ? "*" : "", spec->state_names[s]);
+}
+
+static void printDfaTable(const AutomatonSpec *spec) {
+    int columns = spec->alphabet_size + 1;
+    int widths[257];
+    char cells[257][64];
+
+    widths[0] = 9;
+    strcpy(cells[0], "State");
+    for (int a = 0; a < spec->alphabet_size; a++) {
+        widths[a + 1] = 12;
+        snprintf(cells[a + 1], 64, "Input: %c", spec->alphabet[a]);
+    }
+    printRule(widths, columns, "┌", "┬", "┐");
+    printRow(widths, columns, cells);
+    printRule(widths, columns, "├", "┼", "┤");
+
+    for (int s = 0; s < spec->num_states; s++) {
+        stateLabel(spec, s, cells[0]);
+        for (int a = 0; a < spec->alphabet_size; a++) {
+            strcpy(cells[a + 1], "-");
+            for (int i = 0; i < spec->num_transitions; i++) {
+                const SpecTransition *t = &spec->transitions[i];
+                if (t->from == s && (t->input == SPEC_ANY || t->input == (unsigned char)spec->alphabet[a]))
+                    snprintf(cells[a + 1], 64, "%s", spec->state_names[t->to]);
+            }
+        }
+        printRow(widths, columns, cells);
+    }
+    printRule(widths, columns, "└", "┴", "┘");
+}
+
+static void printStackTable(const AutomatonSpec *spec) {
+    int widths[5] = { 7, 8, 11, 18, 12 };
+    char cells[5][64] = { "State", "Input", "Stack Top", "Action", "Next State" };
+
+    printRule(widths, 5, "┌", "┬", "┐");
+    printRow(widths, 5, cells);
+    printRule(widths, 5, "├", "┼", "┤");
+
+    for (int i = 0; i < spec->num_transitions; i++) {
+        const SpecTransition *t = &spec->transitions[i];
+
+        stateLabel(spec, t->from, cells[0]);
+        if (t->input == SPEC_EPSILON) {
+            strcpy(cells[1], "ε");
+        } else if (t->input == SPEC_ANY) {
+            int len = 0;
+            for (int a = 0; a < spec->alphabet_size && len < 60; a++) {
+                len += snprintf(cells[1] + len, (size_t)(64 - len), a ? "/%c" : "%c", spec->alphabet[a]);
+            }
+        } else {
+            snprintf(cells[1], 64, "%c", t->input);
+        }
+        if (t->top == SPEC_ANY)
+            strcpy(cells[2], "-");
+        else
+            snprintf(cells[2], 64, "%c", t->top);
+
+        if (t->pop && t->push[0])
+            snprintf(cells[3], 64, "Pop, push %s", t->push);
+        else if (t->pop && t->top != SPEC_ANY)
+            snprintf(cells[3], 64, "Pop %c", t->top);
+        else if (t->pop)
+            strcpy(cells[3], "Pop");
+        else if (t->push[0])
+            snprintf(cells[3], 64, "Push %s", t->push);
+        else
+            strcpy(cells[3], "No action");
+
+        stateLabel(spec, t->to, cells[4]);
+        printRow(widths, 5, cells);
+    }
+    printRule(widths, 5, "└", "┴", "┘");
+}
+
+/*
+ * Column heading for a class of bytes: the byte itself, "other" for the
+ * largest class, or its members as ranges
+ */
+static void classLabel(const int *class_of, int k, bool largest, char *out) {
+    int len = snprintf(out, 64, "Input: ");
+    int count = 0;
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        count += class_of[c] == k;
+    }
+    if (largest && count > 1) {
+        snprintf(out + len, (size_t)(64 - len), "other");
+        return;
+    }
+    for (int c = 0; c < DFA_SYMBOLS && len < 48; c++) {
+        if (class_of[c] != k || (c > 0 && class_of[c - 1] == k))
+            continue;
+        int last = c;
+        while (last + 1 < DFA_SYMBOLS && class_of[last + 1] == k)
+            last++;
+        len += snprintf(out + len, (size_t)(64 - len), c > ' ' && c < 127 ? "%c" : "\\x%02x", c);
+        if (last > c)
+            len += snprintf(out + len, (size_t)(64 - len), last > ' ' && last < 127 ? "-%c" : "-\\x%02x", last);
+    }
+    if (len >= 48)
+        snprintf(out + 44, 20, "...");
+}
+
+void specPrintDfaTable(const Dfa *dfa, const char *const names[]) {
+    int class_of[DFA_SYMBOLS];
+    int k = dfaByteClasses(dfa, class_of, NULL);
+    int columns = k + 1;
+    int widths[DFA_SYMBOLS + 1];
+    char cells[DFA_SYMBOLS + 1][64];
+
+    int size[DFA_SYMBOLS] = { 0 };
+    int largest = 0;
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        size[class_of[c]]++;
+    }
+    for (int j = 1; j < k; j++) {
+        if (size[j] > size[largest])
+            largest = j;
+    }
+
+    widths[0] = 9;
+    strcpy(cells[0], "State");
+    for (int j = 0; j < k; j++) {
+        classLabel(class_of, j, j == largest, cells[j + 1]);
+        widths[j + 1] = displayWidth(cells[j + 1]) + 4;
+        if (widths[j + 1] < 12)
+            widths[j + 1] = 12;
+    }
+    printRule(widths, columns, "┌", "┬", "┐");
+    printRow(widths, columns, cells);
+    printRule(widths, columns, "├", "┼", "┤");
+
+    for (int s = 0; s < dfa->num_states; s++) {
+        const char *accept = dfaIsAccepting(dfa, (DfaState)s) ? "*" : "";
+        if (names)
+            snprintf(cells[0], 64, "%s%s", accept, names[s]);
+        else
+            snprintf(cells[0], 64, "%sq%d", accept, s);
+        for (int j = 0, c = 0; c < DFA_SYMBOLS; c++) {
+            if (class_of[c] != j)
+                continue;
+            int t = dfaStep(dfa, (DfaState)s, (unsigned char)c);
+            if (names)
+                snprintf(cells[j + 1], 64, "%s", names[t]);
+            else
+                snprintf(cells[j + 1], 64, "q%d", t);
+            j++;
+        }
+        printRow(widths, columns, cells);
+    }
+    printRule(widths, columns, "└", "┴", "┘");
+    if (names)
+        printf("* denotes accept state; %s is the start\n\n", names[dfa->start]);
+    else
+        printf("* denotes accept state; q%d is the start\n\n", dfa->start);
+}
+
+void specPrintTable(const AutomatonSpec *spec) {
+    if (spec->type == SPEC_DFA)
+        printDfaTable(spec);
+    else
+        printStackTable(spec);
+
+    printf("* denotes accept state");
+    if (spec->type != SPEC_DFA) {
+        if (spec->accept_stack == ACCEPT_STACK_BOTTOM)
+            printf(", with only %c left on the stack", spec->bottom);
+        else if (spec->accept_stack == ACCEPT_STACK_EMPTY)
+            printf(", with an empty stack");
+        if (spec->bottom >= 0)
+            printf("; %c = stack bottom", spec->bottom);
+    }
+    printf("\n\n");
+}
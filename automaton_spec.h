@@ -0,0 +1,160 @@
+#ifndef AUTOMATON_SPEC_H
+#define AUTOMATON_SPEC_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "dfa_engine.h"
+#include "pda_engine.h"
+
+/*
+ * Plain-text automaton descriptions
+ *
+ * One directive or transition per line, '#' starts a comment:
+ *
+ *     type pda                 # dfa, pda or npda
+ *     states S0 S1 S2 S3
+ *     alphabet 0 1             # input symbols, one character each
+ *     stack 0                  # stack symbols (pda/npda)
+ *     bottom $                 # bottom-of-stack marker, pushed before the run
+ *     start S0
+ *     accept S2
+ *     accept-stack bottom      # any, bottom or empty (pda/npda)
+ *     S0 0 * -> S0 push 0      # state input [top] -> next [pop] [push SYMBOLS]
+ *     S0 1 $ -> S2
+ *     S0 1 0 -> S1 pop
+ *
+ * DFA transitions have no top column. An input of '*' stands for every
+ * alphabet symbol and '-' for an epsilon move (npda only); a top of '*'
+ * matches any stack top. "push" takes the symbols in push order, so the
+ * last one ends on top. Epsilon moves must not form a cycle that pushes
+ * more than it pops.
+ */
+
+#define SPEC_MAX_STATES 256
+#define SPEC_MAX_NAME 32
+#define SPEC_MAX_PUSH PDA_MAX_PUSH
+#define SPEC_ANY (-1)       // '*' in the input or top column
+#define SPEC_EPSILON (-2)   // '-' in the input column
+
+typedef enum {
+    SPEC_DFA,
+    SPEC_PDA,
+    SPEC_NPDA
+} SpecType;
+
+/*
+ * One transition line
+ *
+ * @param from - Source state
+ * @param input - Input byte, SPEC_ANY or SPEC_EPSILON
+ * @param top - Required stack top, or SPEC_ANY
+ * @param to - Target state
+ * @param pop - Pop the top before pushing
+ * @param push - Symbols pushed in order, NUL-terminated
+ * @param line - Line number in the source, for messages
+ */
+typedef struct {
+    int from;
+    int input;
+    int top;
+    int to;
+    bool pop;
+    char push[SPEC_MAX_PUSH + 1];
+    int line;
+} SpecTransition;
+
+/*
+ * A parsed automaton description
+ */
+typedef struct {
+    SpecType type;
+    int num_states;
+    char state_names[SPEC_MAX_STATES][SPEC_MAX_NAME];
+    bool accepting[SPEC_MAX_STATES];
+    int start;
+    char alphabet[256];
+    int alphabet_size;
+    char stack_alphabet[256];
+    int stack_size;
+    int bottom;                 // bottom marker, or -1 if none
+    AcceptStack accept_stack;
+    SpecTransition *transitions;
+    int num_transitions;
+} AutomatonSpec;
+
+/*
+ * Parse a description held in memory
+ *
+ * @param spec - Receives the parsed description
+ * @param text - The description, NUL-terminated
+ * @param error - Receives "line N: reason" on failure
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 on a syntax or consistency error
+ */
+int specParse(AutomatonSpec *spec, const char *text, char *error, size_t error_size);
+
+/*
+ * Read and parse a description file
+ *
+ * @param spec - Receives the parsed description
+ * @param path - The file to read
+ * @param error - Receives the reason on failure
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 on failure
+ */
+int specLoad(AutomatonSpec *spec, const char *path, char *error, size_t error_size);
+
+/*
+ * Free the transitions of a parsed description
+ *
+ * @param spec - The description
+ */
+void specFree(AutomatonSpec *spec);
+
+/*
+ * Build the dense runtime table for a DFA description
+ *
+ * Missing transitions and bytes outside the alphabet lead to an extra
+ * dead state numbered num_states; dfaMinimize() folds it into an existing
+ * sink if there is one.
+ *
+ * @param spec - A description of type dfa
+ * @param dfa - Receives the table
+ * @param error - Receives the reason on failure
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 if the description is not a deterministic DFA
+ */
+int specBuildDfa(const AutomatonSpec *spec, Dfa *dfa, char *error, size_t error_size);
+
+/*
+ * Build the dense runtime table for a PDA description
+ *
+ * A top of '*' covers every stack symbol and the empty stack. As for
+ * DFAs, missing moves lead to an extra dead state numbered num_states.
+ *
+ * @param spec - A description of type pda
+ * @param pda - Receives the table
+ * @param error - Receives the reason on failure
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 if the description is not a deterministic PDA
+ */
+int specBuildPda(const AutomatonSpec *spec, Pda *pda, char *error, size_t error_size);
+
+/*
+ * Print the transition table of a description as a box-drawn table
+ *
+ * @param spec - The description
+ */
+void specPrintTable(const AutomatonSpec *spec);
+
+/*
+ * Print a DFA table that has no description behind it, one column per
+ * byte class (see dfaByteClasses())
+ *
+ * @param dfa - The DFA
+ * @param names - Name of each state, or NULL to number them q0, q1, ...
+ */
+void specPrintDfaTable(const Dfa *dfa, const char *const names[]);
+
+#endif
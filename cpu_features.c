@@ -0,0 +1,30 @@
+#include "cpu_features.h"
+
+#ifdef CPU_HAVE_AVX2
+
+// Written only by cpuProbe(), before main() starts any thread
+static bool has_avx2;
+
+/*
+ * Probe the CPU before main()
+ *
+ * __builtin_cpu_init() must be called first when this runs ahead of the
+ * runtime's own constructors.
+ */
+__attribute__((constructor))
+static void cpuProbe(void) {
+    __builtin_cpu_init();
+    has_avx2 = __builtin_cpu_supports("avx2");
+}
+
+bool cpuHasAvx2(void) {
+    return has_avx2;
+}
+
+#else
+
+bool cpuHasAvx2(void) {
+    return false;
+}
+
+#endif
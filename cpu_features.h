@@ -0,0 +1,41 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <stdbool.h>
+
+/*
+ * Vector units for the SIMD kernels of dfa_engine.c and pda_engine.c
+ *
+ * CPU_HAVE_SSE2 and CPU_HAVE_NEON are set when the compiler targets them,
+ * so the kernels can use them unconditionally. CPU_HAVE_AVX2 only says the
+ * compiler can emit AVX2 code for functions marked target("avx2"); whether
+ * the running CPU has it is asked of cpuHasAvx2().
+ */
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPU_HAVE_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CPU_HAVE_AVX2 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPU_HAVE_NEON 1
+#endif
+
+/*
+ * Whether the running CPU supports AVX2
+ *
+ * The CPU is probed once, by a constructor that runs before main(), so
+ * any thread may call this.
+ *
+ * @return true if AVX2 kernels may be run, always false without
+ *         CPU_HAVE_AVX2
+ */
+bool cpuHasAvx2(void);
+
+#endif
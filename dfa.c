@@ -1,6 +1,19 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
+
+#include "automaton_spec.h"
+#include "dfa_engine.h"
+#include "dfa_equiv.h"
+#include "dfa_minimize.h"
+#include "dfa_multi.h"
+#include "dfa_parallel.h"
+#include "dfa_regex.h"
+#include "dfa_stride.h"
+#include "exactly_one_one_dfa.h"
+#include "input_stream.h"
 
 // ANSI color codes
 #define PINK_BG "\033[48;5;218m"
@@ -13,61 +26,227 @@
 #define CYAN "\033[36m"
 #define WHITE "\033[37m"
 
+#define TRACE_LIMIT 100 // longer strings skip the per-character trace
+#define BUILTIN_PATTERN "0*10*" // the built-in language as a regular expression
+#define STRIDE_MAX_STATES 4096 // 8-symbol stride tables up to 2 MiB
+
 typedef enum {
     S0, // initial state
-    S1,
-    S2, // final state
+    S1, // accept state
+    S2, // sink state
 } State;
 
+// Built-in description of the machine, same format as specs/exactly_one_one.dfa
+static const char BUILTIN_SPEC[] =
+    "type dfa\n"
+    "states S0 S1 S2\n"
+    "alphabet 0 1\n"
+    "start S0\n"
+    "accept S1\n"
+    "S0 0 -> S0\n"
+    "S0 1 -> S1\n"
+    "S1 0 -> S1\n"
+    "S1 1 -> S2\n"
+    "S2 * -> S2\n";
+
+// Transition table for the machine, built and minimized once in main()
+static Dfa machine;
+static AutomatonSpec spec;
+static const char *state_names[SPEC_MAX_STATES + 1]; // name of each minimized state
+static bool custom_machine;                           // loaded with --spec or --regex
+static bool regex_machine;                            // compiled from --regex, states unnamed
+static DfaStride stride;                              // 8 symbols per lookup, binary alphabets only
+static bool have_stride;
+static RegexLazy lazy;                                // --regex too big for a table, built while reading
+static bool lazy_machine;
+
+// All machines when more than one --spec or --regex is given, checked in one pass
+static AutomatonSpec specs[DFA_MULTI_MAX];
+static Dfa machines[DFA_MULTI_MAX];
+
+// A machine named on the command line
+typedef struct {
+    const char *text; // description file or pattern
+    bool regex;       // text is a pattern
+} MachineSource;
+
 /*
- * Transition function for the DFA
- * 
- * @param currentState - The current state of the DFA
- * @param input - The input character
- * @return The next state of the DFA
+ * Build a machine from a description file, or the built-in one
+ *
+ * Minimized states are named after their lowest-numbered original member;
+ * a leftover dead state for bytes outside the alphabet is called "dead".
+ *
+ * @param path - Description file, NULL for the built-in machine
+ * @param desc - Receives the parsed description
+ * @param dfa - Receives the minimized table
+ * @param names - Receives the name of each table state, or NULL
+ * @return 0 on success, -1 if the description is invalid
  */
-State transation(State currentState, char input) {
+int loadMachine(const char *path, AutomatonSpec *desc, Dfa *dfa, const char **names) {
+    char error[256];
+    int result = path ? specLoad(desc, path, error, sizeof(error))
+                      : specParse(desc, BUILTIN_SPEC, error, sizeof(error));
+    if (result != 0) {
+        fprintf(stderr, "Invalid automaton description: %s\n", error);
+        return -1;
+    }
 
-    // Error checking for invalid input
-    if (input != '0' && input != '1' ) {
-        return -1; // Invalid input
+    Dfa table;
+    if (specBuildDfa(desc, &table, error, sizeof(error)) != 0) {
+        fprintf(stderr, "Invalid automaton description: %s: %s\n", path ? path : "built-in", error);
+        specFree(desc);
+        return -1;
     }
 
-    switch (currentState) {
+    int state_map[SPEC_MAX_STATES + 1];
+    dfaMinimize(&table, dfa, state_map);
+    dfaFree(&table);
 
-// State S0 - Initial state for 0's and 1's       
-        case S0:
-            if (input == '0')
-                return S0;
-            else if (input == '1')
-                return S1;
-            break;
+    // Walk downwards so the lowest original member names each state
+    for (int s = desc->num_states; names && s >= 0; s--) {
+        if (state_map[s] >= 0)
+            names[state_map[s]] = s == desc->num_states ? "dead" : desc->state_names[s];
+    }
+    return 0;
+}
 
-// State S1 - Trap state for 0's transitionary for next state on input 1
-        case S1:
-            if (input == '0')
-                return S1; // Stay in S1
-            else if (input == '1')
-                return S2; // Transition to S2
-            break;
+/*
+ * Compile a pattern and minimize the result
+ *
+ * A pattern with more DFA states than a table can hold may instead become
+ * the lazy main machine, built as the input is read.
+ *
+ * @param pattern - The pattern (see dfa_regex.h)
+ * @param dfa - Receives the minimized table
+ * @param allow_lazy - Fall back to the lazy DFA instead of failing
+ * @return 0 on success, -1 if the pattern is invalid or too big
+ */
+int loadPattern(const char *pattern, Dfa *dfa, bool allow_lazy) {
+    char error[256];
+    Dfa table;
+    int result = regexCompile(pattern, &table, error, sizeof(error));
+    if (result == -2 && allow_lazy) {
+        regexLazyInit(&lazy, pattern, REGEX_LAZY_DEFAULT_CACHE, error, sizeof(error));
+        lazy_machine = true;
+        return 0;
+    }
+    if (result != 0) {
+        fprintf(stderr, "Invalid pattern '%s': %s\n", pattern, error);
+        return -1;
+    }
+    dfaMinimize(&table, dfa, NULL);
+    dfaFree(&table);
+    return 0;
+}
 
-// State S2 - Accept state for one [1]
-        case S2:
-            if (input == '0')
-                return S2; // Stay in S2
-            else if (input == '1')
-                return S2; // Transition to S3
-            break;
+/*
+ * Build a machine from a --spec or --regex argument
+ *
+ * @param allow_lazy - Let a pattern too big for a table become the lazy main machine
+ * @return 0 on success, -1 on an invalid description or pattern
+ */
+int loadSource(const MachineSource *source, AutomatonSpec *desc, Dfa *dfa, const char **names, bool allow_lazy) {
+    if (source->regex)
+        return loadPattern(source->text, dfa, allow_lazy);
+    return loadMachine(source->text, desc, dfa, names);
+}
+
+/*
+ * Print the transition table of a loaded machine
+ *
+ * @param source - Where the machine came from, NULL for the built-in one
+ */
+void printTable(const MachineSource *source, const AutomatonSpec *desc, const Dfa *dfa) {
+    if (source && source->regex && lazy_machine)
+        printf("More than %d states: built on demand while reading, in a cache of %u KiB\n\n",
+            DFA_MAX_STATES, REGEX_LAZY_DEFAULT_CACHE >> 10);
+    else if (source && source->regex)
+        specPrintDfaTable(dfa, NULL);
+    else
+        specPrintTable(desc);
+}
+
+/*
+ * Name of a state of the main machine, for verdict lines
+ */
+const char *stateName(DfaState state) {
+    static char name[16];
+    if (!regex_machine)
+        return state_names[state];
+    snprintf(name, sizeof(name), "q%d", state);
+    return name;
+}
+
+/*
+ * Build the 8-symbol stride table for the main machine if its alphabet has
+ * two symbols and the table stays small
+ */
+void buildStride() {
+    unsigned char zero, one;
+    if (!lazy_machine && machine.num_states <= STRIDE_MAX_STATES && dfaStrideAlphabet(&machine, &zero, &one)) {
+        dfaStrideInit(&stride, &machine, zero, one, DFA_STRIDE_MAX);
+        have_stride = true;
     }
-    
-    return currentState;
+}
+
+/*
+ * Run the main machine over a block, stopping early at a sink
+ *
+ * @param state - The state to start from, receives the final state
+ * @return Number of bytes consumed
+ */
+size_t runMachine(DfaState *state, const char *input, size_t len) {
+    if (lazy_machine) {
+        int current = *state;
+        size_t consumed = regexLazyRun(&lazy, &current, input, len);
+        *state = (DfaState)current;
+        return consumed;
+    }
+    if (have_stride)
+        return dfaStrideRun(&stride, state, input, len);
+    return dfaRunUntilSink(&machine, state, input, len);
+}
+
+/*
+ * Start state of the main machine
+ */
+DfaState machineStart() {
+    return lazy_machine ? (DfaState)lazy.start : machine.start;
+}
+
+/*
+ * Check whether the main machine accepts in a state
+ */
+bool machineAccepts(DfaState state) {
+    return lazy_machine ? regexLazyIsAccepting(&lazy, state) : dfaIsAccepting(&machine, state);
+}
+
+/*
+ * Check whether a state of the main machine settles the verdict
+ */
+bool machineIsSink(DfaState state) {
+    return lazy_machine ? state == lazy.dead : dfaIsSink(&machine, state);
+}
+
+/*
+ * Transition function for the DFA
+ * 
+ * Looks the move up in the dense table built from BUILTIN_SPEC.
+ * Bytes other than '0' and '1' lead to the S2 sink.
+ *
+ * @param currentState - The current state of the DFA
+ * @param input - The input character
+ * @return The next state of the DFA
+ */
+State transation(State currentState, char input) {
+    return (State)dfaStep(&machine, (DfaState)currentState, (unsigned char)input);
 }
 
 
 
 /* Validate input string contains only 0s and 1s */
 int validateInput(const char* str) {
-    for (int i = 0; str[i] !=  '\0'; i++) {
+    for (size_t i = 0; str[i] !=  '\0'; i++) {
         if ( str[i] != '0' && str[i] != '1') {
             return 0;
         }
@@ -119,14 +298,39 @@ void printWelcomeMessage() {
     printf("============================================\n");
     printf(RESET);
         printf("\n" YELLOW "DFA Transition Table:" RESET "\n");
-    printf("┌─────────┬────────────┬────────────┐\n");
-    printf("│  State  │  Input: 0  │  Input: 1  │\n");
-    printf("├─────────┼────────────┼────────────┤\n");
-    printf("│   S0    │     S0     │     S1     │\n");
-    printf("│  *S1    │     S1     │     S2     │\n");
-    printf("│   S2    │     S2     │     S2     │\n");
-    printf("└─────────┴────────────┴────────────┘\n");
-    printf("* denotes accept state\n\n");
+    specPrintTable(&spec);
+}
+
+/*
+ * Print an input in double quotes, with bytes other than printable ASCII
+ * as \xHH
+ */
+void printEscaped(const char *input, size_t len) {
+    putchar('"');
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)input[i];
+        printf(c > ' ' && c < 127 && c != '\\' && c != '"' ? "%c" : "\\x%02x", c);
+    }
+    putchar('"');
+}
+
+/*
+ * Prove another table for the built-in language equal to the main machine,
+ * or show an input they disagree on
+ *
+ * @param name - What the other table is
+ * @param other - The other table
+ */
+void reportEquivalence(const char *name, const Dfa *other) {
+    char witness[64];
+    size_t len;
+    if (dfaEquivalent(&machine, other, witness, sizeof(witness), &len)) {
+        printf(GREEN "Proved equivalent: " RESET "%s\n", name);
+        return;
+    }
+    printf(RED "Not equivalent: %s disagrees with the table on " RESET, name);
+    printEscaped(witness, len < sizeof(witness) ? len : sizeof(witness));
+    printf("\n");
 }
 
 /*
@@ -164,6 +368,18 @@ void runTestCases() {
 
     
         printf(YELLOW "\n--- Running DFA Test Cases ---\n" RESET);
+
+        // The same language compiled from its regular expression
+        Dfa compiledPattern;
+        if (loadPattern(BUILTIN_PATTERN, &compiledPattern, false) != 0)
+            return;
+
+        // Prove the tables behind the other engines equal to this one
+        Dfa guiMachine;
+        dfaBuildExactlyOneOne(&guiMachine);
+        reportEquivalence("GUI table (dfaBuildExactlyOneOne)", &guiMachine);
+        reportEquivalence("pattern " BUILTIN_PATTERN, &compiledPattern);
+        dfaFree(&guiMachine);
         
         for (size_t i = 0; i < numTests; i++) {
 
@@ -177,11 +393,46 @@ void runTestCases() {
             printf(WHITE "Processing string..." RESET "\n");
             printf("Start State: S0\n");
     
-            for (size_t i = 0; i < strlen(input_string_); i++) {
-                char currentChar = input_string_[i];
-                currentState = transation(currentState, currentChar);            }
+            size_t len = strlen(input_string_);
+            DfaState finalState = (DfaState)currentState;
+            size_t consumed = dfaRunUntilSink(&machine, &finalState, input_string_, len);
+            currentState = (State)finalState;
+            if (consumed < len) {
+                printf("Stopped early: S%d is a sink, read %zu of %zu characters\n", currentState, consumed, len);
+            }
+
+            // Cross-check the vectorized kernel against the table walk
+            size_t kernelConsumed;
+            State kernelState = (State)dfaExactlyOneOneSimd(input_string_, len, &kernelConsumed);
+            if (kernelState != currentState || kernelConsumed != consumed) {
+                printf(RED "SIMD kernel mismatch: table ended in S%d after %zu characters, kernel in S%d after %zu\n" RESET,
+                    currentState, consumed, kernelState, kernelConsumed);
+            }
+            // ... the 8-symbol stride table ...
+            DfaState strideState = S0;
+            size_t strideConsumed = dfaStrideRun(&stride, &strideState, input_string_, len);
+            if (strideState != currentState || strideConsumed != consumed) {
+                printf(RED "Stride table mismatch: table ended in S%d after %zu characters, stride table in S%d after %zu\n" RESET,
+                    currentState, consumed, strideState, strideConsumed);
+            }
+            // ... and the code generated from specs/exactly_one_one.dfa
+            size_t compiledConsumed;
+            State compiledState = (State)exactlyOneOneRun(S0, input_string_, len, &compiledConsumed);
+            if (compiledState != currentState || compiledConsumed != consumed) {
+                printf(RED "Generated code mismatch: table ended in S%d after %zu characters, generated code in S%d after %zu\n" RESET,
+                    currentState, consumed, compiledState, compiledConsumed);
+            }
+            // ... and the DFA compiled from BUILTIN_PATTERN
+            DfaState patternState = compiledPattern.start;
+            size_t patternConsumed = dfaRunUntilSink(&compiledPattern, &patternState, input_string_, len);
+            bool patternAccepts = dfaIsAccepting(&compiledPattern, patternState);
+            if (patternAccepts != dfaIsAccepting(&machine, (DfaState)currentState) || patternConsumed != consumed) {
+                printf(RED "Pattern " BUILTIN_PATTERN " mismatch: table %s after %zu characters, pattern %s after %zu\n" RESET,
+                    dfaIsAccepting(&machine, (DfaState)currentState) ? "accepted" : "rejected", consumed,
+                    patternAccepts ? "accepted" : "rejected", patternConsumed);
+            }
     
-            if (currentState == S1) {
+            if (dfaIsAccepting(&machine, (DfaState)currentState)) {
                 printf(GREEN "\n==================================================\n" RESET);
                 printf("Final State is S1. String '%s' is " GREEN "Accepted!\n" RESET, testCases[i].input);
                 printf(GREEN "==================================================\n" RESET);
@@ -215,6 +466,7 @@ void runTestCases() {
  }
 
  printf("└──────────────────┴────────────────┴──────────┘\n");
+ dfaFree(&compiledPattern);
         
         printf(CYAN "\n---------------------------------------------------------------------\n" RESET);
         printf(YELLOW "--- Demonstration Complete ---\n\n" RESET);
@@ -229,13 +481,15 @@ void runTestCases() {
      */
 void runManual(){
      State currentState = S0;
-     char input_string[100];
+     char *input_string = NULL;
+     size_t capacity = 0;
      char again = 'y';
 
     while (again == 'y' || again == 'Y') {
         printf("•Enter a binary string that has only one occurence of '1' |  Example: 1, 01, 00010, etc: \n  ");
 
-        scanf("%99s", input_string);
+        if (!readWord(stdin, &input_string, &capacity))
+            break;
         
         if (!validateInput(input_string)) {
             printf(RED "ERROR: Invalid input! Use only 0s and 1s.\n" RESET);
@@ -244,10 +498,22 @@ void runManual(){
         else {
         printf("\nPROCESSING BINARY STRING...\n");
         printf("-------------------------------------------\n\n");
+        size_t len = strlen(input_string);
+        if (len > TRACE_LIMIT) {
+            // Too long to trace, split it across all cores instead
+            printf("-Read: %zu characters on %d thread(s), trace skipped\n", len, parallelDefaultThreads());
+            currentState = (State)dfaRunParallel(&machine, (DfaState)currentState, input_string, len, 0);
+        }
+        else {
         // cuurrent state check
-        for (size_t i = 0; i < strlen(input_string); i++) {
+        for (size_t i = 0; i < len; i++) {
             char currentChar = input_string[i];
             currentState = transation(currentState, currentChar);
+            if (dfaIsSink(&machine, (DfaState)currentState) && i + 1 < len) {
+                printf("-Read: %c | " WHITE "current state : → 'S%d' (sink) \n" RESET, currentChar, currentState);
+                printf("-Stopped early: read %zu of %zu characters\n", i + 1, len);
+                break;
+            }
 
             if (currentState == S0){
                 printf("-Read: %c | " WHITE " cuurent state : → 'S%d' \n" RESET, currentChar, currentState);            }
@@ -258,9 +524,10 @@ void runManual(){
                 printf("-Read: %c | " WHITE "current state : → 'S%d' \n" RESET, currentChar, currentState);            
         }
         }
+        }
 
         //Final state check
-        if (currentState == S1) {
+        if (dfaIsAccepting(&machine, (DfaState)currentState)) {
             printf("\n");
             printf("============================================\n");
             printf("Final state for string: %s → " GREEN "Accepted! One occurence of [1] only. \n" RESET, input_string);
@@ -298,12 +565,428 @@ void runManual(){
         scanf(" %c", &again);
         printf("\n");
     }
+    free(input_string);
 }
 
 
 
 
-int main() {
+/*
+ * Check a whole file or stdin as one string, without the 100-character cap
+ *
+ * Reads in STREAM_CHUNK_SIZE pieces and carries only the DFA state between
+ * them, so memory use does not depend on the input length. Reading stops
+ * as soon as the DFA enters a sink.
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error
+ */
+int runStream(const char *path) {
+    InputStream stream;
+    if (streamOpen(&stream, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+
+    DfaState state = machineStart();
+    size_t consumed = 0;
+    const char *chunk;
+    size_t len;
+    // Stop reading once a sink settles the result
+    while (!machineIsSink(state) && (len = streamRead(&stream, &chunk)) > 0) {
+        consumed += runMachine(&state, chunk, len);
+    }
+
+    int status;
+    if (ferror(stream.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    } else {
+        bool accepted = machineAccepts(state);
+        printf("%s: final state %s after %zu characters%s\n", accepted ? "ACCEPT" : "REJECT", stateName(state),
+            consumed, machineIsSink(state) ? " (stopped at sink)" : "");
+        status = accepted ? 0 : 1;
+    }
+    streamClose(&stream);
+    return status;
+}
+
+/*
+ * Check a whole file as one string, straight from a read-only mapping
+ *
+ * No bytes are copied; the mapped input is split across all cores by
+ * dfaRunParallel().
+ *
+ * @param path - File to map
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error
+ */
+int runMapped(const char *path) {
+    MappedInput input;
+    if (mapInput(&input, path) != 0) {
+        fprintf(stderr, "Cannot map %s: %s\n", path,
+            errno == ENODEV ? "not a regular file, read it with --stream" : strerror(errno));
+        return 2;
+    }
+
+    // Walk the first block alone: inputs that hit a sink early never start the threads.
+    // A lazy machine has no table to share between threads and walks it all.
+    DfaState state = machineStart();
+    size_t prefix = input.len < DFA_PARALLEL_MIN_CHUNK || lazy_machine ? input.len : DFA_PARALLEL_MIN_CHUNK;
+    size_t consumed = runMachine(&state, input.data, prefix);
+    if (consumed == prefix && !machineIsSink(state)) {
+        state = dfaRunParallel(&machine, state, input.data + prefix, input.len - prefix, 0);
+        consumed = input.len;
+    }
+    bool accepted = machineAccepts(state);
+    printf("%s: final state %s after %zu characters%s\n", accepted ? "ACCEPT" : "REJECT", stateName(state),
+        consumed, consumed < input.len ? " (stopped at sink)" : "");
+
+    unmapInput(&input);
+    return accepted ? 0 : 1;
+}
+
+/*
+ * Non-interactive batch mode: one string per input line, one verdict per
+ * output line ("ACCEPT" or "REJECT"), with no trace, art or colors
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 when every line was checked, 2 on I/O error
+ */
+int runBatch(const char *path) {
+    LineReader reader;
+    if (lineReaderOpen(&reader, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    const char *line;
+    size_t len;
+    while (readLine(&reader, &line, &len)) {
+        // The vectorized kernel only knows the built-in language
+        DfaState state = machineStart();
+        if (custom_machine)
+            runMachine(&state, line, len);
+        else
+            state = dfaExactlyOneOneSimd(line, len, NULL);
+        bool accepted = machineAccepts(state);
+        fputs(accepted ? "ACCEPT\n" : "REJECT\n", stdout);
+    }
+
+    int status = 0;
+    if (ferror(reader.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    }
+    lineReaderClose(&reader);
+    fflush(stdout);
+    return status;
+}
+
+/*
+ * Print one verdict per machine for a whole input
+ *
+ * @return 0 if every machine accepted, 1 otherwise
+ */
+static int printVerdicts(const DfaMulti *multi, uint32_t verdicts, const MachineSource sources[], size_t len) {
+    for (int i = 0; i < multi->count; i++) {
+        bool accepted = (verdicts >> i) & 1;
+        printf("%s: %s after %zu characters\n", accepted ? "ACCEPT" : "REJECT", sources[i].text, len);
+    }
+    uint32_t all = multi->count == 32 ? 0xFFFFFFFFu : (1u << multi->count) - 1;
+    return verdicts == all ? 0 : 1;
+}
+
+/*
+ * --stream with several machines: every chunk is read once and fed to all
+ * of them together
+ *
+ * @param multi - The machines
+ * @param sources - Description file or pattern of each machine
+ * @param path - File to read, NULL for stdin
+ * @return 0 if every machine accepted, 1 if any rejected, 2 on I/O error
+ */
+int runMultiStream(const DfaMulti *multi, const MachineSource sources[], const char *path) {
+    InputStream stream;
+    if (streamOpen(&stream, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+
+    DfaMultiCursor cursor;
+    dfaMultiStart(multi, &cursor);
+    const char *chunk;
+    size_t len;
+    while ((len = streamRead(&stream, &chunk)) > 0) {
+        dfaMultiRun(multi, &cursor, chunk, len);
+    }
+
+    int status;
+    if (ferror(stream.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    } else {
+        status = printVerdicts(multi, dfaMultiVerdicts(multi, &cursor), sources, stream.total);
+    }
+    streamClose(&stream);
+    return status;
+}
+
+/*
+ * --mmap with several machines
+ *
+ * @param multi - The machines
+ * @param sources - Description file or pattern of each machine
+ * @param path - File to map
+ * @return 0 if every machine accepted, 1 if any rejected, 2 on I/O error
+ */
+int runMultiMapped(const DfaMulti *multi, const MachineSource sources[], const char *path) {
+    MappedInput input;
+    if (mapInput(&input, path) != 0) {
+        fprintf(stderr, "Cannot map %s: %s\n", path,
+            errno == ENODEV ? "not a regular file, read it with --stream" : strerror(errno));
+        return 2;
+    }
+    int status = printVerdicts(multi, dfaMultiAccepts(multi, input.data, input.len), sources, input.len);
+    unmapInput(&input);
+    return status;
+}
+
+/*
+ * --batch with several machines: one line of space-separated verdicts per
+ * input line, in command-line order
+ *
+ * @param multi - The machines
+ * @param path - File to read, NULL for stdin
+ * @return 0 when every line was checked, 2 on I/O error
+ */
+int runMultiBatch(const DfaMulti *multi, const char *path) {
+    LineReader reader;
+    if (lineReaderOpen(&reader, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    const char *line;
+    size_t len;
+    while (readLine(&reader, &line, &len)) {
+        uint32_t verdicts = dfaMultiAccepts(multi, line, len);
+        for (int i = 0; i < multi->count; i++) {
+            fputs((verdicts >> i) & 1 ? "ACCEPT" : "REJECT", stdout);
+            putchar(i == multi->count - 1 ? '\n' : ' ');
+        }
+    }
+
+    int status = 0;
+    if (ferror(reader.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    }
+    lineReaderClose(&reader);
+    fflush(stdout);
+    return status;
+}
+
+/*
+ * Print command-line usage
+ *
+ * @param prog - Program name from argv[0]
+ */
+void printUsage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  (no options)       interactive menu\n");
+    fprintf(stderr, "  --stream [FILE]    check all of FILE (default stdin) as one string\n");
+    fprintf(stderr, "  --mmap FILE        same, reading FILE through a memory mapping\n");
+    fprintf(stderr, "  --batch [FILE]     one string per line in, one ACCEPT/REJECT per line out\n");
+    fprintf(stderr, "  --spec FILE        use the DFA described in FILE (see specs/) for the\n");
+    fprintf(stderr, "                     modes above; on its own, print its transition table\n");
+    fprintf(stderr, "  --regex PATTERN    same, with the DFA compiled from PATTERN, which must\n");
+    fprintf(stderr, "                     match the whole input (e.g. '0*10*')\n");
+    fprintf(stderr, "                     repeat either to check every machine in one pass (up to %d)\n", DFA_MULTI_MAX);
+    fprintf(stderr, "  --equiv            with two machines given by --spec/--regex, or one and the\n");
+    fprintf(stderr, "                     built-in machine: prove they accept the same strings\n");
+}
+
+/*
+ * Take an optional file operand following a flag
+ *
+ * @return The operand, or NULL if the next argument is another flag
+ */
+static const char *optionalPath(int argc, char *argv[], int *i) {
+    if (*i + 1 < argc && (argv[*i + 1][0] != '-' || strcmp(argv[*i + 1], "-") == 0))
+        return argv[++(*i)];
+    return NULL;
+}
+
+typedef enum { MODE_NONE, MODE_STREAM, MODE_MMAP, MODE_BATCH, MODE_TABLE, MODE_EQUIV } Mode;
+
+/*
+ * --equiv: prove that two machines accept the same strings, or print an
+ * input they disagree on
+ *
+ * @param sources - Two machines, or one to compare with the built-in machine
+ * @param num_sources - 1 or 2
+ * @return 0 if equivalent, 1 if not, 2 if a machine could not be loaded
+ */
+int runEquivalence(const MachineSource sources[], int num_sources) {
+    const char *names[2] = { "built-in", "built-in" };
+    int loaded = 0;
+    int status = 2;
+
+    if (num_sources == 1 && loadMachine(NULL, &specs[0], &machines[0], NULL) == 0)
+        loaded++;
+    while (loaded < 2 && loadSource(&sources[loaded + num_sources - 2], &specs[loaded], &machines[loaded], NULL, false) == 0) {
+        names[loaded] = sources[loaded + num_sources - 2].text;
+        loaded++;
+    }
+
+    if (loaded == 2) {
+        size_t size = (size_t)machines[0].num_states + machines[1].num_states;
+        char *witness = malloc(size);
+        size_t len;
+        if (!witness) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        if (dfaEquivalent(&machines[0], &machines[1], witness, size, &len)) {
+            printf("EQUIVALENT: %s and %s accept the same strings\n", names[0], names[1]);
+            status = 0;
+        } else {
+            bool first = dfaAccepts(&machines[0], witness, len);
+            printf("DIFFERENT: %s accepts ", names[first ? 0 : 1]);
+            printEscaped(witness, len);
+            printf(", %s does not\n", names[first ? 1 : 0]);
+            status = 1;
+        }
+        free(witness);
+    }
+
+    for (int i = 0; i < loaded; i++) {
+        dfaFree(&machines[i]);
+        specFree(&specs[i]);
+    }
+    return status;
+}
+
+/*
+ * Run a command-line mode against several machines at once
+ *
+ * @param mode - The mode picked on the command line
+ * @param sources - Description file or pattern of each machine
+ * @param num_sources - Number of machines, 2 .. DFA_MULTI_MAX
+ * @param path - Input file for the mode
+ * @return Exit status of the mode
+ */
+int runMulti(Mode mode, const MachineSource sources[], int num_sources, const char *path) {
+    const Dfa *set[DFA_MULTI_MAX];
+    int loaded = 0;
+    int status = 2;
+
+    for (int i = 0; i < DFA_MULTI_MAX; i++) {
+        set[i] = &machines[i];
+    }
+    while (loaded < num_sources && loadSource(&sources[loaded], &specs[loaded], &machines[loaded], NULL, false) == 0)
+        loaded++;
+    if (loaded == num_sources) {
+        DfaMulti multi;
+        dfaMultiInit(&multi, set, num_sources);
+        if (mode == MODE_TABLE) {
+            for (int i = 0; i < num_sources; i++) {
+                printf("%s:\n", sources[i].text);
+                printTable(&sources[i], &specs[i], &machines[i]);
+            }
+            status = 0;
+        } else if (mode == MODE_STREAM)
+            status = runMultiStream(&multi, sources, path);
+        else if (mode == MODE_MMAP)
+            status = runMultiMapped(&multi, sources, path);
+        else if (mode == MODE_BATCH)
+            status = runMultiBatch(&multi, path);
+        dfaMultiFree(&multi);
+    }
+
+    for (int i = 0; i < loaded; i++) {
+        dfaFree(&machines[i]);
+        specFree(&specs[i]);
+    }
+    return status;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        Mode mode = MODE_NONE;
+        const char *path = NULL;
+        MachineSource sources[DFA_MULTI_MAX];
+        int num_sources = 0;
+        bool bad_option = false;
+
+        for (int i = 1; i < argc; i++) {
+            bool regex = strcmp(argv[i], "--regex") == 0;
+            if ((regex || strcmp(argv[i], "--spec") == 0) && i + 1 < argc && num_sources < DFA_MULTI_MAX) {
+                sources[num_sources].text = argv[++i];
+                sources[num_sources++].regex = regex;
+            } else if (strcmp(argv[i], "--stream") == 0) {
+                mode = MODE_STREAM;
+                path = optionalPath(argc, argv, &i);
+            } else if (strcmp(argv[i], "--mmap") == 0 && i + 1 < argc) {
+                mode = MODE_MMAP;
+                path = argv[++i];
+            } else if (strcmp(argv[i], "--batch") == 0) {
+                mode = MODE_BATCH;
+                path = optionalPath(argc, argv, &i);
+            } else if (strcmp(argv[i], "--equiv") == 0) {
+                mode = MODE_EQUIV;
+            } else {
+                bad_option = true;
+                break;
+            }
+        }
+        if (bad_option || (mode == MODE_EQUIV && (num_sources < 1 || num_sources > 2)))
+            mode = MODE_NONE;
+        else if (mode == MODE_NONE && num_sources > 0)
+            mode = MODE_TABLE;
+
+        if (mode == MODE_EQUIV)
+            return runEquivalence(sources, num_sources);
+
+        if (num_sources > 1 && mode != MODE_NONE)
+            return runMulti(mode, sources, num_sources, path);
+
+        // Minimize before running so the table is as small as the language allows
+        custom_machine = num_sources > 0;
+        regex_machine = custom_machine && sources[0].regex;
+        if (mode != MODE_NONE && custom_machine && loadSource(&sources[0], &spec, &machine, state_names, true) != 0)
+            return 2;
+        if (mode != MODE_NONE && !custom_machine && loadMachine(NULL, &spec, &machine, state_names) != 0)
+            return 2;
+        buildStride();
+
+        int status = 2;
+        if (mode == MODE_TABLE) {
+            printTable(&sources[0], &spec, &machine);
+            status = 0;
+        } else if (mode == MODE_STREAM)
+            status = runStream(path);
+        else if (mode == MODE_MMAP)
+            status = runMapped(path);
+        else if (mode == MODE_BATCH)
+            status = runBatch(path);
+        else
+            printUsage(argv[0]);
+        if (have_stride)
+            dfaStrideFree(&stride);
+        if (lazy_machine)
+            regexLazyFree(&lazy);
+        dfaFree(&machine);
+        specFree(&spec);
+        return status;
+    }
+
+    if (loadMachine(NULL, &spec, &machine, state_names) != 0)
+        return 2;
+    buildStride();
+
     printWelcomeMessage();
     int menuChoice = 0;
 
@@ -337,6 +1020,10 @@ int main() {
     printf("Bye ~~\n");
     // Reset color
     printf(RESET);
+    if (have_stride)
+        dfaStrideFree(&stride);
+    dfaFree(&machine);
+    specFree(&spec);
     return 0;
 }
 
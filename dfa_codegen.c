@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include "automaton_spec.h"
+#include "dfa_engine.h"
+#include "dfa_equiv.h"
+#include "dfa_minimize.h"
+
+/*
+ * Ahead-of-time DFA compiler
+ *
+ * Reads a DFA description, minimizes it, checks the result against the
+ * description with dfaEquivalent() and writes a C source/header pair
+ * in which every state is a label and every transition a direct jump:
+ *
+ *     dfa_codegen SPEC NAME OUT.c OUT.h
+ *
+ * defines
+ *
+ *     DfaState NAMERun(DfaState state, const char *input, size_t len, size_t *consumed);
+ *     bool NAMEAccepts(const char *input, size_t len);
+ *
+ * with the same state numbering as dfaMinimize() gives the table built by
+ * specBuildDfa(). With GCC or Clang each state dispatches through its own
+ * 256-entry label table (computed goto); other compilers get one switch per
+ * state. Sinks return as soon as they are entered, and
+ * *consumed tells how far the run got.
+ */
+
+static const char *state_names[SPEC_MAX_STATES + 1];
+
+/*
+ * Write a byte as a C character constant
+ */
+static void printByte(FILE *out, int c) {
+    if (isalnum(c))
+        fprintf(out, "'%c'", c);
+    else
+        fprintf(out, "0x%02x", c);
+}
+
+/*
+ * Most frequent target of a state, used as the switch default
+ */
+static int commonTarget(const Dfa *dfa, int s) {
+    static int count[DFA_MAX_STATES + 1];
+    int best = dfaStep(dfa, (DfaState)s, 0);
+
+    memset(count, 0, (size_t)dfa->num_states * sizeof(int));
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        int t = dfaStep(dfa, (DfaState)s, (unsigned char)c);
+        if (++count[t] > count[best])
+            best = t;
+    }
+    return best;
+}
+
+static void emitHeader(FILE *out, const char *name, const char *guard, const char *spec_path) {
+    fprintf(out, "/* Generated by dfa_codegen from %s -- do not edit */\n\n", spec_path);
+    fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(out, "#include <stddef.h>\n#include <stdbool.h>\n\n#include \"dfa_engine.h\"\n\n");
+    fprintf(out, "/*\n * Run the compiled DFA over a block of input\n *\n");
+    fprintf(out, " * @param state - The state to start from\n");
+    fprintf(out, " * @param input - The input bytes\n");
+    fprintf(out, " * @param len - Number of input bytes\n");
+    fprintf(out, " * @param consumed - If not NULL, receives the bytes read before a sink\n");
+    fprintf(out, " *                   settled the result (len if none was entered)\n");
+    fprintf(out, " * @return The state after consuming the whole block\n */\n");
+    fprintf(out, "DfaState %sRun(DfaState state, const char *input, size_t len, size_t *consumed);\n\n", name);
+    fprintf(out, "/*\n * Membership test from the start state\n *\n");
+    fprintf(out, " * @param input - The input bytes\n");
+    fprintf(out, " * @param len - Number of input bytes\n");
+    fprintf(out, " * @return true if the input is accepted\n */\n");
+    fprintf(out, "bool %sAccepts(const char *input, size_t len);\n\n#endif\n", name);
+}
+
+static void emitSource(FILE *out, const Dfa *dfa, const char *name, const char *header, const char *spec_path) {
+    int n = dfa->num_states;
+
+    fprintf(out, "/* Generated by dfa_codegen from %s -- do not edit */\n\n", spec_path);
+    fprintf(out, "#include \"%s\"\n\n", header);
+    fprintf(out, "#if defined(__GNUC__)\n#define DISPATCH_GOTO 1\n#endif\n\n");
+    fprintf(out, "#define LEAVE(s) \\\n    do { \\\n");
+    fprintf(out, "        if (consumed) \\\n            *consumed = (size_t)(p - (const unsigned char *)input); \\\n");
+    fprintf(out, "        return (s); \\\n    } while (0)\n\n");
+    fprintf(out, "DfaState %sRun(DfaState state, const char *input, size_t len, size_t *consumed) {\n", name);
+    fprintf(out, "    const unsigned char *p = (const unsigned char *)input;\n");
+    fprintf(out, "    const unsigned char *end = p + len;\n\n");
+
+    // One label table per state, written as runs of equal targets
+    fprintf(out, "#ifdef DISPATCH_GOTO\n");
+    for (int s = 0; s < n; s++) {
+        if (dfaIsSink(dfa, (DfaState)s))
+            continue;
+        fprintf(out, "    static void *const from%d[256] = {", s);
+        for (int c = 0; c < DFA_SYMBOLS;) {
+            int t = dfaStep(dfa, (DfaState)s, (unsigned char)c);
+            int last = c;
+            while (last + 1 < DFA_SYMBOLS && dfaStep(dfa, (DfaState)s, (unsigned char)(last + 1)) == t)
+                last++;
+            fprintf(out, "\n        [");
+            printByte(out, c);
+            if (last > c) {
+                fprintf(out, " ... ");
+                printByte(out, last);
+            }
+            fprintf(out, "] = &&state%d,", t);
+            c = last + 1;
+        }
+        fprintf(out, "\n    };\n");
+    }
+    fprintf(out, "#endif\n\n");
+
+    fprintf(out, "    switch (state) {\n");
+    for (int s = 0; s < n; s++) {
+        fprintf(out, "    case %d: goto state%d;\n", s, s);
+    }
+    fprintf(out, "    default: LEAVE(state);\n    }\n");
+
+    for (int s = 0; s < n; s++) {
+        fprintf(out, "\nstate%d: // %s%s\n", s, state_names[s], dfaIsAccepting(dfa, (DfaState)s) ? ", accept" : "");
+        if (dfaIsSink(dfa, (DfaState)s)) {
+            fprintf(out, "    LEAVE(%d); // sink: the rest of the input cannot change the verdict\n", s);
+            continue;
+        }
+        fprintf(out, "    if (p == end)\n        LEAVE(%d);\n", s);
+        fprintf(out, "#ifdef DISPATCH_GOTO\n    goto *from%d[*p++];\n#else\n", s);
+        fprintf(out, "    switch (*p++) {\n");
+        int common = commonTarget(dfa, s);
+        for (int t = 0; t < n; t++) {
+            if (t == common)
+                continue;
+            bool any = false;
+            for (int c = 0; c < DFA_SYMBOLS; c++) {
+                if (dfaStep(dfa, (DfaState)s, (unsigned char)c) != t)
+                    continue;
+                fprintf(out, "    case ");
+                printByte(out, c);
+                fprintf(out, ":\n");
+                any = true;
+            }
+            if (any)
+                fprintf(out, "        goto state%d;\n", t);
+        }
+        fprintf(out, "    default:\n        goto state%d;\n    }\n#endif\n", common);
+    }
+    fprintf(out, "}\n\n");
+
+    fprintf(out, "bool %sAccepts(const char *input, size_t len) {\n", name);
+    fprintf(out, "    switch (%sRun(%d, input, len, NULL)) {\n", name, dfa->start);
+    for (int s = 0; s < n; s++) {
+        if (dfaIsAccepting(dfa, (DfaState)s))
+            fprintf(out, "    case %d:\n", s);
+    }
+    fprintf(out, "        return true;\n    default:\n        return false;\n    }\n}\n");
+}
+
+/*
+ * Header guard from the header's file name, e.g. "gen/foo_dfa.h" -> FOO_DFA_H
+ */
+static void makeGuard(const char *header, char *guard, size_t size) {
+    size_t j = 0;
+    for (const char *p = header; *p && j + 1 < size; p++) {
+        guard[j++] = isalnum((unsigned char)*p) ? (char)toupper((unsigned char)*p) : '_';
+    }
+    guard[j] = '\0';
+}
+
+static const char *baseName(const char *path) {
+    const char *slash = strrchr(path, '/');
+    const char *backslash = strrchr(path, '\\');
+    if (backslash && (!slash || backslash > slash))
+        slash = backslash;
+    return slash ? slash + 1 : path;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "Usage: %s SPEC NAME OUT.c OUT.h\n", argv[0]);
+        return 2;
+    }
+    const char *spec_path = argv[1], *name = argv[2];
+    const char *source_path = argv[3], *header_path = argv[4];
+
+    AutomatonSpec spec;
+    char error[256];
+    if (specLoad(&spec, spec_path, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s\n", error);
+        return 2;
+    }
+    Dfa table, machine;
+    if (specBuildDfa(&spec, &table, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", spec_path, error);
+        specFree(&spec);
+        return 2;
+    }
+    int state_map[SPEC_MAX_STATES + 1];
+    dfaMinimize(&table, &machine, state_map);
+    // Never emit code for a machine that is not provably the described one
+    bool equivalent = dfaEquivalent(&table, &machine, NULL, 0, NULL);
+    dfaFree(&table);
+    if (!equivalent) {
+        fprintf(stderr, "%s: minimized machine is not equivalent to the description\n", spec_path);
+        dfaFree(&machine);
+        specFree(&spec);
+        return 2;
+    }
+    for (int s = spec.num_states; s >= 0; s--) {
+        if (state_map[s] >= 0)
+            state_names[state_map[s]] = s == spec.num_states ? "dead" : spec.state_names[s];
+    }
+
+    const char *header = baseName(header_path);
+    char guard[256];
+    makeGuard(header, guard, sizeof(guard));
+
+    FILE *source = fopen(source_path, "w");
+    FILE *header_file = source ? fopen(header_path, "w") : NULL;
+    if (!source || !header_file) {
+        fprintf(stderr, "Cannot write %s: %s\n", source ? header_path : source_path, strerror(errno));
+        if (source)
+            fclose(source);
+        return 2;
+    }
+    emitSource(source, &machine, name, header, baseName(spec_path));
+    emitHeader(header_file, name, guard, baseName(spec_path));
+
+    int status = 0;
+    if (fclose(source) != 0 || fclose(header_file) != 0) {
+        fprintf(stderr, "Write error: %s\n", strerror(errno));
+        status = 2;
+    }
+    dfaFree(&machine);
+    specFree(&spec);
+    return status;
+}
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_features.h"
+#include "dfa_engine.h"
+
+#define SINK_CHECK_BLOCK 256 // bytes between sink checks in dfaRunUntilSink()
+
+void dfaInit(Dfa *dfa, int num_states, DfaState start, DfaState fallback) {
+    size_t cells = (size_t)num_states * DFA_SYMBOLS;
+
+    dfa->next = malloc(cells * sizeof(DfaState));
+    dfa->accept = calloc((size_t)(num_states + 7) / 8, 1);
+    dfa->loops = calloc((size_t)num_states, sizeof(uint16_t));
+    if (!dfa->next || !dfa->accept || !dfa->loops) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < cells; i++) {
+        dfa->next[i] = fallback;
+    }
+    dfa->loops[fallback] = DFA_SYMBOLS;
+    dfa->num_states = num_states;
+    dfa->start = start;
+}
+
+void dfaFree(Dfa *dfa) {
+    free(dfa->next);
+    free(dfa->accept);
+    free(dfa->loops);
+    dfa->next = NULL;
+    dfa->accept = NULL;
+    dfa->loops = NULL;
+    dfa->num_states = 0;
+}
+
+void dfaSetTransition(Dfa *dfa, DfaState from, unsigned char symbol, DfaState to) {
+    DfaState *cell = &dfa->next[(size_t)from * DFA_SYMBOLS + symbol];
+
+    dfa->loops[from] += (uint16_t)(to == from) - (uint16_t)(*cell == from);
+    *cell = to;
+}
+
+void dfaSetAccept(Dfa *dfa, DfaState state, bool accepting) {
+    if (accepting)
+        dfa->accept[state >> 3] |= (uint8_t)(1u << (state & 7));
+    else
+        dfa->accept[state >> 3] &= (uint8_t)~(1u << (state & 7));
+}
+
+DfaState dfaRun(const Dfa *dfa, DfaState state, const char *input, size_t len) {
+    const DfaState *next = dfa->next;
+    const unsigned char *p = (const unsigned char *)input;
+
+    for (size_t i = 0; i < len; i++) {
+        state = next[(size_t)state * DFA_SYMBOLS + p[i]];
+    }
+    return state;
+}
+
+size_t dfaRunUntilSink(const Dfa *dfa, DfaState *state, const char *input, size_t len) {
+    DfaState s = *state;
+    size_t done = 0;
+
+    // Check for a sink once per block, then find the exact byte that entered it
+    while (done < len && !dfaIsSink(dfa, s)) {
+        size_t block = len - done < SINK_CHECK_BLOCK ? len - done : SINK_CHECK_BLOCK;
+        DfaState end = dfaRun(dfa, s, input + done, block);
+        if (!dfaIsSink(dfa, end)) {
+            s = end;
+            done += block;
+            continue;
+        }
+        while (!dfaIsSink(dfa, s)) {
+            s = dfaStep(dfa, s, (unsigned char)input[done++]);
+        }
+    }
+    *state = s;
+    return done;
+}
+
+bool dfaAccepts(const Dfa *dfa, const char *input, size_t len) {
+    DfaState state = dfa->start;
+    dfaRunUntilSink(dfa, &state, input, len);
+    return dfaIsAccepting(dfa, state);
+}
+
+int dfaByteClasses(const Dfa *dfa, int *class_of, int *representative) {
+    int first[DFA_SYMBOLS]; // lowest byte of each class
+    int k = 0;
+
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        int found = -1;
+        for (int j = 0; j < k && found < 0; j++) {
+            bool same = true;
+            for (int s = 0; s < dfa->num_states && same; s++) {
+                same = dfaStep(dfa, (DfaState)s, (unsigned char)c) == dfaStep(dfa, (DfaState)s, (unsigned char)first[j]);
+            }
+            if (same)
+                found = j;
+        }
+        if (found < 0) {
+            found = k;
+            first[k++] = c;
+        }
+        if (class_of)
+            class_of[c] = found;
+    }
+    if (representative)
+        memcpy(representative, first, (size_t)k * sizeof(int));
+    return k;
+}
+
+void dfaBuildExactlyOneOne(Dfa *dfa) {
+    enum { S0, S1, S2 };
+
+    dfaInit(dfa, 3, S0, S2);
+
+    dfaSetTransition(dfa, S0, '0', S0);
+    dfaSetTransition(dfa, S0, '1', S1);
+    dfaSetTransition(dfa, S1, '0', S1);
+    dfaSetTransition(dfa, S1, '1', S2);
+    // S2 is the sink, already the fallback for every symbol
+
+    dfaSetAccept(dfa, S1, true);
+}
+
+// ---- Vectorized kernel for the "exactly one '1'" language ----
+
+#if defined(__GNUC__)
+#define POPCOUNT32(x) ((unsigned)__builtin_popcount(x))
+#else
+static unsigned POPCOUNT32(uint32_t x) {
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+#endif
+
+/*
+ * Scalar tail: count '1' bytes, returning 2 on a second '1' or a bad byte
+ *
+ * The vector loops stop at the first block that settles the verdict and
+ * leave it to this loop, which finds the exact byte for *consumed.
+ */
+static unsigned countOnesScalar(const unsigned char *p, size_t len, unsigned ones, size_t *consumed) {
+    for (size_t i = 0; i < len; i++) {
+        if (p[i] == '1') {
+            if (++ones >= 2) {
+                *consumed = i + 1;
+                return 2;
+            }
+        } else if (p[i] != '0') {
+            *consumed = i + 1;
+            return 2;
+        }
+    }
+    *consumed = len;
+    return ones;
+}
+
+/*
+ * Finish a vectorized count in scalar code from block offset i
+ */
+static unsigned finishScalar(const unsigned char *p, size_t i, size_t len, unsigned ones, size_t *consumed) {
+    unsigned result = countOnesScalar(p + i, len - i, ones, consumed);
+    *consumed += i;
+    return result;
+}
+
+#ifdef CPU_HAVE_AVX2
+__attribute__((target("avx2")))
+static unsigned countOnesAvx2(const unsigned char *p, size_t len, size_t *consumed) {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i one = _mm256_set1_epi8('1');
+    unsigned ones = 0;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(p + i + 32));
+        __m256i a1 = _mm256_cmpeq_epi8(a, one);
+        __m256i b1 = _mm256_cmpeq_epi8(b, one);
+        __m256i ok = _mm256_and_si256(_mm256_or_si256(a1, _mm256_cmpeq_epi8(a, zero)),
+                                      _mm256_or_si256(b1, _mm256_cmpeq_epi8(b, zero)));
+
+        if ((uint32_t)_mm256_movemask_epi8(ok) != 0xFFFFFFFFu)
+            break;
+        unsigned block = POPCOUNT32((uint32_t)_mm256_movemask_epi8(a1)) +
+                         POPCOUNT32((uint32_t)_mm256_movemask_epi8(b1));
+        if (ones + block >= 2)
+            break;
+        ones += block;
+    }
+    return finishScalar(p, i, len, ones, consumed);
+}
+#endif
+
+#ifdef CPU_HAVE_SSE2
+static unsigned countOnesSse2(const unsigned char *p, size_t len, size_t *consumed) {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i one = _mm_set1_epi8('1');
+    unsigned ones = 0;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(p + i + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *)(p + i + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *)(p + i + 48));
+        __m128i e0 = _mm_cmpeq_epi8(v0, one), e1 = _mm_cmpeq_epi8(v1, one);
+        __m128i e2 = _mm_cmpeq_epi8(v2, one), e3 = _mm_cmpeq_epi8(v3, one);
+        __m128i ok = _mm_and_si128(
+            _mm_and_si128(_mm_or_si128(e0, _mm_cmpeq_epi8(v0, zero)),
+                          _mm_or_si128(e1, _mm_cmpeq_epi8(v1, zero))),
+            _mm_and_si128(_mm_or_si128(e2, _mm_cmpeq_epi8(v2, zero)),
+                          _mm_or_si128(e3, _mm_cmpeq_epi8(v3, zero))));
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+            break;
+        uint32_t lo = (uint32_t)_mm_movemask_epi8(e0) | ((uint32_t)_mm_movemask_epi8(e1) << 16);
+        uint32_t hi = (uint32_t)_mm_movemask_epi8(e2) | ((uint32_t)_mm_movemask_epi8(e3) << 16);
+        unsigned block = POPCOUNT32(lo) + POPCOUNT32(hi);
+        if (ones + block >= 2)
+            break;
+        ones += block;
+    }
+    return finishScalar(p, i, len, ones, consumed);
+}
+#endif
+
+#ifdef CPU_HAVE_NEON
+static unsigned countOnesNeon(const unsigned char *p, size_t len, size_t *consumed) {
+    const uint8x16_t zero = vdupq_n_u8('0');
+    const uint8x16_t one = vdupq_n_u8('1');
+    unsigned ones = 0;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        uint8x16x4_t v = vld1q_u8_x4(p + i);
+        uint8x16_t e0 = vceqq_u8(v.val[0], one), e1 = vceqq_u8(v.val[1], one);
+        uint8x16_t e2 = vceqq_u8(v.val[2], one), e3 = vceqq_u8(v.val[3], one);
+        uint8x16_t ok = vandq_u8(
+            vandq_u8(vorrq_u8(e0, vceqq_u8(v.val[0], zero)), vorrq_u8(e1, vceqq_u8(v.val[1], zero))),
+            vandq_u8(vorrq_u8(e2, vceqq_u8(v.val[2], zero)), vorrq_u8(e3, vceqq_u8(v.val[3], zero))));
+
+        if (vminvq_u8(ok) == 0)
+            break;
+        // each lane is 0 or 1 after the shift, so the 64-lane sum fits a byte
+        uint8x16_t sum = vaddq_u8(vaddq_u8(vshrq_n_u8(e0, 7), vshrq_n_u8(e1, 7)),
+                                  vaddq_u8(vshrq_n_u8(e2, 7), vshrq_n_u8(e3, 7)));
+        unsigned block = vaddvq_u8(sum);
+        if (ones + block >= 2)
+            break;
+        ones += block;
+    }
+    return finishScalar(p, i, len, ones, consumed);
+}
+#endif
+
+DfaState dfaExactlyOneOneSimd(const char *input, size_t len, size_t *consumed) {
+    const unsigned char *p = (const unsigned char *)input;
+    size_t ignored;
+    if (!consumed)
+        consumed = &ignored;
+
+#if defined(CPU_HAVE_AVX2)
+    if (cpuHasAvx2())
+        return (DfaState)countOnesAvx2(p, len, consumed);
+#endif
+#if defined(CPU_HAVE_SSE2)
+    return (DfaState)countOnesSse2(p, len, consumed);
+#elif defined(CPU_HAVE_NEON)
+    return (DfaState)countOnesNeon(p, len, consumed);
+#else
+    return (DfaState)countOnesScalar(p, len, 0, consumed);
+#endif
+}
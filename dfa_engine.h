@@ -0,0 +1,177 @@
+#ifndef DFA_ENGINE_H
+#define DFA_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DFA_SYMBOLS 256      // one table column per input byte
+#define DFA_MAX_STATES 65535
+
+typedef uint16_t DfaState;
+
+/*
+ * Table-driven DFA
+ *
+ * @param num_states - Number of states, numbered 0 .. num_states-1
+ * @param start - The initial state
+ * @param next - Dense transition table, next[state * DFA_SYMBOLS + symbol]
+ * @param accept - Accept-set bitmap, one bit per state
+ * @param loops - Number of bytes leading each state back to itself, kept
+ *                up to date by dfaSetTransition(); DFA_SYMBOLS marks a sink
+ */
+typedef struct {
+    int num_states;
+    DfaState start;
+    DfaState *next;
+    uint8_t *accept;
+    uint16_t *loops;
+} Dfa;
+
+/*
+ * Allocate a DFA whose transitions all lead to one fallback state
+ *
+ * @param dfa - The DFA to initialise
+ * @param num_states - Number of states
+ * @param start - The initial state
+ * @param fallback - Target of every transition not set explicitly
+ */
+void dfaInit(Dfa *dfa, int num_states, DfaState start, DfaState fallback);
+
+/*
+ * Free the tables of a DFA
+ *
+ * @param dfa - The DFA to free
+ */
+void dfaFree(Dfa *dfa);
+
+/*
+ * Set one transition of the DFA
+ *
+ * @param dfa - The DFA
+ * @param from - Source state
+ * @param symbol - Input byte
+ * @param to - Target state
+ */
+void dfaSetTransition(Dfa *dfa, DfaState from, unsigned char symbol, DfaState to);
+
+/*
+ * Mark a state as accepting or non-accepting
+ *
+ * @param dfa - The DFA
+ * @param state - The state
+ * @param accepting - true to add the state to the accept set
+ */
+void dfaSetAccept(Dfa *dfa, DfaState state, bool accepting);
+
+/*
+ * Single transition lookup
+ *
+ * @param dfa - The DFA
+ * @param state - The current state
+ * @param symbol - The input byte
+ * @return The next state
+ */
+static inline DfaState dfaStep(const Dfa *dfa, DfaState state, unsigned char symbol) {
+    return dfa->next[(size_t)state * DFA_SYMBOLS + symbol];
+}
+
+/*
+ * Check the accept-set bitmap
+ *
+ * @param dfa - The DFA
+ * @param state - The state to test
+ * @return true if the state is accepting
+ */
+static inline bool dfaIsAccepting(const Dfa *dfa, DfaState state) {
+    return (dfa->accept[state >> 3] >> (state & 7)) & 1;
+}
+
+/*
+ * Check whether a state is a sink
+ *
+ * Once a run enters a sink no further input can change the final state,
+ * so membership loops may stop there.
+ *
+ * @param dfa - The DFA
+ * @param state - The state to test
+ * @return true if every byte leads from the state back to itself
+ */
+static inline bool dfaIsSink(const Dfa *dfa, DfaState state) {
+    return dfa->loops[state] == DFA_SYMBOLS;
+}
+
+/*
+ * Run the DFA over a block of input
+ *
+ * @param dfa - The DFA
+ * @param state - The state to start from
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return The state after consuming the whole block
+ */
+DfaState dfaRun(const Dfa *dfa, DfaState state, const char *input, size_t len);
+
+/*
+ * Run the DFA over a block of input, stopping early at a sink
+ *
+ * @param dfa - The DFA
+ * @param state - The state to start from, receives the final state
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t dfaRunUntilSink(const Dfa *dfa, DfaState *state, const char *input, size_t len);
+
+/*
+ * Membership test from the start state
+ *
+ * @param dfa - The DFA
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return true if the input is accepted
+ */
+bool dfaAccepts(const Dfa *dfa, const char *input, size_t len);
+
+/*
+ * Group the bytes whose columns are identical in every state
+ *
+ * Bytes in one class drive every state to the same place, so passes over
+ * the table only need one column per class.
+ *
+ * @param dfa - The DFA
+ * @param class_of - If not NULL, receives the class of each byte
+ * @param representative - If not NULL, receives the lowest byte of each
+ *                         class; classes are numbered in that order
+ * @return Number of classes
+ */
+int dfaByteClasses(const Dfa *dfa, int *class_of, int *representative);
+
+/*
+ * Build the "exactly one '1'" machine over {0,1}
+ *
+ * States keep the S0/S1/S2 numbering used by dfa.c and GUI.c:
+ * S0 no '1' seen, S1 one '1' seen (accept), S2 more than one (sink).
+ * Bytes other than '0' and '1' lead to S2.
+ *
+ * @param dfa - The DFA to initialise
+ */
+void dfaBuildExactlyOneOne(Dfa *dfa);
+
+/*
+ * Vectorized membership kernel for the "exactly one '1'" machine
+ *
+ * Counts '1' bytes 64 at a time (AVX2 or SSE2 on x86, NEON on AArch64,
+ * scalar elsewhere) and stops as soon as a second '1' or a byte outside
+ * {0,1} is seen. The result is the state the S0/S1/S2 table ends in.
+ *
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @param consumed - If not NULL, receives the number of bytes read before
+ *                   the verdict was settled (up to and including the byte
+ *                   that led to S2)
+ * @return S0 (0), S1 (1) or S2 (2)
+ */
+DfaState dfaExactlyOneOneSimd(const char *input, size_t len, size_t *consumed);
+
+#endif
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfa_equiv.h"
+
+static void *xmalloc(size_t size) {
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    return p;
+}
+
+/*
+ * Root of a state's set, halving the path on the way
+ */
+static int find(int *parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/*
+ * Merge the sets of two states
+ *
+ * @return false if they were already in one set
+ */
+static bool unite(int *parent, int *rank, int x, int y) {
+    x = find(parent, x);
+    y = find(parent, y);
+    if (x == y)
+        return false;
+    if (rank[x] < rank[y]) {
+        int t = x;
+        x = y;
+        y = t;
+    }
+    parent[y] = x;
+    if (rank[x] == rank[y])
+        rank[x]++;
+    return true;
+}
+
+bool dfaEquivalent(const Dfa *a, const Dfa *b, char *witness, size_t witness_size, size_t *witness_len) {
+    int na = a->num_states;
+    int n = na + b->num_states; // b's states follow a's in the union-find
+
+    // One byte per class of the two machines together
+    int class_a[DFA_SYMBOLS], class_b[DFA_SYMBOLS];
+    int ka = dfaByteClasses(a, class_a, NULL);
+    int kb = dfaByteClasses(b, class_b, NULL);
+    bool *seen = calloc((size_t)ka * kb, sizeof(bool));
+    unsigned char bytes[DFA_SYMBOLS];
+    int num_bytes = 0;
+    if (!seen) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        int pair = class_a[c] * kb + class_b[c];
+        if (!seen[pair]) {
+            seen[pair] = true;
+            bytes[num_bytes++] = (unsigned char)c;
+        }
+    }
+    free(seen);
+
+    int *parent = xmalloc((size_t)n * sizeof(int));
+    int *rank = calloc((size_t)n, sizeof(int));
+    if (!rank) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int s = 0; s < n; s++) {
+        parent[s] = s;
+    }
+
+    // Queued pairs, with the pair and byte that led to each for the witness
+    DfaState *left = xmalloc((size_t)n * sizeof(DfaState));
+    DfaState *right = xmalloc((size_t)n * sizeof(DfaState));
+    int *from = xmalloc((size_t)n * sizeof(int));
+    unsigned char *via = xmalloc((size_t)n);
+    int head = 0, tail = 0;
+
+    unite(parent, rank, a->start, na + b->start);
+    left[tail] = a->start;
+    right[tail] = b->start;
+    from[tail++] = -1;
+
+    bool equivalent = true;
+    while (head < tail) {
+        int pair = head++;
+        DfaState p = left[pair], q = right[pair];
+
+        if (dfaIsAccepting(a, p) != dfaIsAccepting(b, q)) {
+            equivalent = false;
+            // The bytes on the path back to the start pair, reversed
+            size_t len = 0;
+            for (int i = pair; from[i] >= 0; i = from[i]) {
+                len++;
+            }
+            size_t pos = len;
+            for (int i = pair; from[i] >= 0; i = from[i]) {
+                if (witness && --pos < witness_size)
+                    witness[pos] = (char)via[i];
+            }
+            if (witness_len)
+                *witness_len = len;
+            break;
+        }
+        for (int j = 0; j < num_bytes; j++) {
+            DfaState p2 = dfaStep(a, p, bytes[j]);
+            DfaState q2 = dfaStep(b, q, bytes[j]);
+            if (unite(parent, rank, p2, na + q2)) {
+                left[tail] = p2;
+                right[tail] = q2;
+                from[tail] = pair;
+                via[tail++] = bytes[j];
+            }
+        }
+    }
+
+    free(via);
+    free(from);
+    free(right);
+    free(left);
+    free(rank);
+    free(parent);
+    return equivalent;
+}
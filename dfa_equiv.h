@@ -0,0 +1,29 @@
+#ifndef DFA_EQUIV_H
+#define DFA_EQUIV_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "dfa_engine.h"
+
+/*
+ * Decide whether two DFAs accept the same language
+ *
+ * Hopcroft and Karp's algorithm: starting from the pair of start states,
+ * states reached by the same input are merged with union-find, and a
+ * merged pair whose accept bits differ disproves equivalence. Each
+ * successful merge queues one pair, so the work is near-linear in the
+ * states times the number of byte classes, with no minimization needed.
+ * The machines may number their states differently.
+ *
+ * @param a - The first DFA, usually the reference
+ * @param b - The second DFA
+ * @param witness - If not NULL, receives an input the machines disagree on
+ *                  (up to witness_size bytes, not NUL-terminated)
+ * @param witness_size - Size of the witness buffer
+ * @param witness_len - If not NULL, receives the full length of the witness
+ * @return true if the machines are equivalent
+ */
+bool dfaEquivalent(const Dfa *a, const Dfa *b, char *witness, size_t witness_size, size_t *witness_len);
+
+#endif
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfa_minimize.h"
+
+/*
+ * Partition of the reachable states into blocks
+ *
+ * Each block is a contiguous range of elems; the first marked[b] states of
+ * block b are the ones marked by the current splitter.
+ */
+typedef struct {
+    int *elems;     // states grouped by block
+    int *loc;       // position of each state in elems
+    int *block_of;  // block of each state
+    int *first;     // start of each block in elems
+    int *end;       // one past the end of each block
+    int *marked;    // marked states at the front of each block
+    int num_blocks;
+} Partition;
+
+static void *xmalloc(size_t size) {
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    return p;
+}
+
+/*
+ * Move a state into the marked front section of its block
+ */
+static void markState(Partition *part, int s) {
+    int b = part->block_of[s];
+    int pos = part->loc[s];
+    int dest = part->first[b] + part->marked[b];
+
+    if (pos < dest)
+        return; // already marked
+    int other = part->elems[dest];
+    part->elems[dest] = s;
+    part->loc[s] = dest;
+    part->elems[pos] = other;
+    part->loc[other] = pos;
+    part->marked[b]++;
+}
+
+int dfaMinimize(const Dfa *in, Dfa *out, int *state_map) {
+    int n = in->num_states;
+
+    // ---- Symbol classes: bytes with identical columns behave alike ----
+    int representative[DFA_SYMBOLS];
+    int k = dfaByteClasses(in, NULL, representative);
+
+    // ---- Reachable states, renumbered 0..m-1 in original order ----
+    int *reach_id = xmalloc((size_t)n * sizeof(int));
+    int *queue = xmalloc((size_t)n * sizeof(int));
+    for (int s = 0; s < n; s++) {
+        reach_id[s] = -1;
+    }
+    int head = 0, tail = 0;
+    reach_id[in->start] = 0;
+    queue[tail++] = in->start;
+    while (head < tail) {
+        int s = queue[head++];
+        for (int j = 0; j < k; j++) {
+            int t = dfaStep(in, (DfaState)s, (unsigned char)representative[j]);
+            if (reach_id[t] < 0) {
+                reach_id[t] = 0;
+                queue[tail++] = t;
+            }
+        }
+    }
+    int m = 0;
+    int *orig = xmalloc((size_t)n * sizeof(int));
+    for (int s = 0; s < n; s++) {
+        if (reach_id[s] >= 0) {
+            orig[m] = s;
+            reach_id[s] = m++;
+        }
+    }
+
+    // ---- Inverse transitions per class: pred[c][t] = { s : delta(s,c) = t } ----
+    int *pred_start = xmalloc(((size_t)k * m + 1) * sizeof(int));
+    int *pred = xmalloc((size_t)k * m * sizeof(int));
+    memset(pred_start, 0, ((size_t)k * m + 1) * sizeof(int));
+    for (int j = 0; j < k; j++) {
+        for (int s = 0; s < m; s++) {
+            int t = reach_id[dfaStep(in, (DfaState)orig[s], (unsigned char)representative[j])];
+            pred_start[(size_t)j * m + t + 1]++;
+        }
+    }
+    for (size_t i = 0; i < (size_t)k * m; i++) {
+        pred_start[i + 1] += pred_start[i];
+    }
+    int *fill = xmalloc((size_t)k * m * sizeof(int));
+    memcpy(fill, pred_start, (size_t)k * m * sizeof(int));
+    for (int j = 0; j < k; j++) {
+        for (int s = 0; s < m; s++) {
+            int t = reach_id[dfaStep(in, (DfaState)orig[s], (unsigned char)representative[j])];
+            pred[fill[(size_t)j * m + t]++] = s;
+        }
+    }
+    free(fill);
+
+    // ---- Initial partition: accepting / non-accepting ----
+    Partition part;
+    part.elems = xmalloc((size_t)m * sizeof(int));
+    part.loc = xmalloc((size_t)m * sizeof(int));
+    part.block_of = xmalloc((size_t)m * sizeof(int));
+    part.first = xmalloc((size_t)m * sizeof(int));
+    part.end = xmalloc((size_t)m * sizeof(int));
+    part.marked = xmalloc((size_t)m * sizeof(int));
+    part.num_blocks = 0;
+
+    int pos = 0;
+    for (int pass = 1; pass >= 0; pass--) {
+        int begin = pos;
+        for (int s = 0; s < m; s++) {
+            if (dfaIsAccepting(in, (DfaState)orig[s]) == (pass == 1)) {
+                part.elems[pos] = s;
+                part.loc[s] = pos++;
+                part.block_of[s] = part.num_blocks;
+            }
+        }
+        if (pos > begin) {
+            part.first[part.num_blocks] = begin;
+            part.end[part.num_blocks] = pos;
+            part.marked[part.num_blocks] = 0;
+            part.num_blocks++;
+        }
+    }
+
+    // ---- Worklist of (block, class) splitters ----
+    char *in_work = xmalloc((size_t)m * k);
+    int *work = xmalloc((size_t)m * k * sizeof(int));
+    int num_work = 0;
+    memset(in_work, 0, (size_t)m * k);
+    if (part.num_blocks == 2) {
+        int smaller = (part.end[0] - part.first[0]) <= (part.end[1] - part.first[1]) ? 0 : 1;
+        for (int j = 0; j < k; j++) {
+            in_work[(size_t)smaller * k + j] = 1;
+            work[num_work++] = smaller * k + j;
+        }
+    }
+
+    int *touched_states = xmalloc((size_t)m * sizeof(int));
+    int *touched_blocks = xmalloc((size_t)m * sizeof(int));
+
+    while (num_work > 0) {
+        int item = work[--num_work];
+        int splitter = item / k, j = item % k;
+        in_work[item] = 0;
+
+        // Collect predecessors first: marking reorders elems, splitter included
+        int num_states = 0;
+        for (int p = part.first[splitter]; p < part.end[splitter]; p++) {
+            int t = part.elems[p];
+            for (int q = pred_start[(size_t)j * m + t]; q < pred_start[(size_t)j * m + t + 1]; q++) {
+                touched_states[num_states++] = pred[q];
+            }
+        }
+
+        int num_blocks_touched = 0;
+        for (int i = 0; i < num_states; i++) {
+            int s = touched_states[i];
+            int b = part.block_of[s];
+            if (part.marked[b] == 0)
+                touched_blocks[num_blocks_touched++] = b;
+            markState(&part, s);
+        }
+
+        for (int i = 0; i < num_blocks_touched; i++) {
+            int b = touched_blocks[i];
+            int marked = part.marked[b];
+            int size = part.end[b] - part.first[b];
+            part.marked[b] = 0;
+            if (marked == size)
+                continue;
+
+            // Split the marked front off into a new block
+            int nb = part.num_blocks++;
+            part.first[nb] = part.first[b];
+            part.end[nb] = part.first[b] + marked;
+            part.marked[nb] = 0;
+            part.first[b] = part.end[nb];
+            for (int p = part.first[nb]; p < part.end[nb]; p++) {
+                part.block_of[part.elems[p]] = nb;
+            }
+
+            int small = marked <= size - marked ? nb : b;
+            for (int a = 0; a < k; a++) {
+                size_t old_item = (size_t)b * k + a;
+                size_t new_item = (size_t)nb * k + a;
+                size_t add = in_work[old_item] ? new_item : (size_t)small * k + a;
+                if (!in_work[add]) {
+                    in_work[add] = 1;
+                    work[num_work++] = (int)add;
+                }
+            }
+        }
+    }
+
+    // ---- Number blocks by their lowest original state and build the output ----
+    int *block_id = xmalloc((size_t)part.num_blocks * sizeof(int));
+    for (int b = 0; b < part.num_blocks; b++) {
+        block_id[b] = -1;
+    }
+    int num_out = 0;
+    for (int s = 0; s < m; s++) {
+        int b = part.block_of[s];
+        if (block_id[b] < 0)
+            block_id[b] = num_out++;
+    }
+
+    int start = block_id[part.block_of[reach_id[in->start]]];
+    dfaInit(out, num_out, (DfaState)start, (DfaState)start);
+    for (int s = 0; s < m; s++) {
+        int from = block_id[part.block_of[s]];
+        for (int c = 0; c < DFA_SYMBOLS; c++) {
+            int t = reach_id[dfaStep(in, (DfaState)orig[s], (unsigned char)c)];
+            dfaSetTransition(out, (DfaState)from, (unsigned char)c, (DfaState)block_id[part.block_of[t]]);
+        }
+        if (dfaIsAccepting(in, (DfaState)orig[s]))
+            dfaSetAccept(out, (DfaState)from, true);
+    }
+    if (state_map) {
+        for (int s = 0; s < n; s++) {
+            state_map[s] = reach_id[s] < 0 ? -1 : block_id[part.block_of[reach_id[s]]];
+        }
+    }
+
+    free(block_id);
+    free(touched_states);
+    free(touched_blocks);
+    free(work);
+    free(in_work);
+    free(part.elems);
+    free(part.loc);
+    free(part.block_of);
+    free(part.first);
+    free(part.end);
+    free(part.marked);
+    free(pred_start);
+    free(pred);
+    free(orig);
+    free(queue);
+    free(reach_id);
+    return num_out;
+}
@@ -0,0 +1,24 @@
+#ifndef DFA_MINIMIZE_H
+#define DFA_MINIMIZE_H
+
+#include "dfa_engine.h"
+
+/*
+ * Build the minimal DFA for the same language
+ *
+ * Drops unreachable states, then merges equivalent ones with Hopcroft's
+ * O(k n log n) partition refinement. Bytes whose columns are identical in
+ * every state are refined as one symbol class, so k is the number of
+ * distinct columns rather than 256. Surviving states keep the relative
+ * order of their lowest-numbered original member, so an already minimal
+ * machine comes back unchanged.
+ *
+ * @param in - The DFA to minimize
+ * @param out - Receives the minimal DFA (must not alias in)
+ * @param state_map - If not NULL, receives the new number of each original
+ *                    state, or -1 for states that were unreachable
+ * @return Number of states in the minimal DFA
+ */
+int dfaMinimize(const Dfa *in, Dfa *out, int *state_map);
+
+#endif
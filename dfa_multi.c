@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfa_multi.h"
+
+#define HASH_SLOTS (2 * DFA_MULTI_MAX_PRODUCT) // power of two, at most half full
+#define LANE_BLOCK 256                         // bytes between sink checks in lane mode
+
+static void *xmalloc(size_t size) {
+    void *p = malloc(size);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    return p;
+}
+
+static unsigned hashTuple(const DfaState *tuple, int count) {
+    unsigned h = 2166136261u;
+    for (int i = 0; i < count; i++) {
+        h = (h ^ tuple[i]) * 16777619u;
+    }
+    return h & (HASH_SLOTS - 1);
+}
+
+/*
+ * Breadth-first construction of the reachable product states
+ *
+ * @return Number of product states, or 0 if there are more than
+ *         DFA_MULTI_MAX_PRODUCT
+ */
+static int buildProduct(DfaMulti *multi) {
+    int k = multi->count;
+    DfaState *tuples = xmalloc((size_t)DFA_MULTI_MAX_PRODUCT * k * sizeof(DfaState));
+    DfaState *next = xmalloc((size_t)DFA_MULTI_MAX_PRODUCT * DFA_SYMBOLS * sizeof(DfaState));
+    int *slots = calloc(HASH_SLOTS, sizeof(int)); // product id + 1, 0 if empty
+    if (!slots) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    int num = 1;
+    for (int i = 0; i < k; i++) {
+        tuples[i] = multi->machines[i]->start;
+    }
+    slots[hashTuple(tuples, k)] = 1;
+
+    DfaState target[DFA_MULTI_MAX];
+    for (int id = 0; id < num; id++) {
+        const DfaState *from = &tuples[(size_t)id * k];
+        for (int c = 0; c < DFA_SYMBOLS; c++) {
+            for (int i = 0; i < k; i++) {
+                target[i] = dfaStep(multi->machines[i], from[i], (unsigned char)c);
+            }
+
+            unsigned h = hashTuple(target, k);
+            while (slots[h] && memcmp(&tuples[(size_t)(slots[h] - 1) * k], target, k * sizeof(DfaState)) != 0)
+                h = (h + 1) & (HASH_SLOTS - 1);
+            if (!slots[h]) {
+                if (num == DFA_MULTI_MAX_PRODUCT) {
+                    num = 0;
+                    goto done;
+                }
+                memcpy(&tuples[(size_t)num * k], target, k * sizeof(DfaState));
+                slots[h] = ++num;
+            }
+            next[(size_t)id * DFA_SYMBOLS + c] = (DfaState)(slots[h] - 1);
+        }
+    }
+
+    dfaInit(&multi->product, num, 0, 0);
+    for (int id = 0; id < num; id++) {
+        for (int c = 0; c < DFA_SYMBOLS; c++) {
+            dfaSetTransition(&multi->product, (DfaState)id, (unsigned char)c, next[(size_t)id * DFA_SYMBOLS + c]);
+        }
+    }
+    multi->verdicts = xmalloc((size_t)num * sizeof(uint32_t));
+    for (int id = 0; id < num; id++) {
+        uint32_t bits = 0;
+        for (int i = 0; i < k; i++) {
+            if (dfaIsAccepting(multi->machines[i], tuples[(size_t)id * k + i]))
+                bits |= 1u << i;
+        }
+        multi->verdicts[id] = bits;
+        if (bits)
+            dfaSetAccept(&multi->product, (DfaState)id, true);
+    }
+
+done:
+    free(slots);
+    free(next);
+    free(tuples);
+    return num;
+}
+
+int dfaMultiInit(DfaMulti *multi, const Dfa *const machines[], int count) {
+    memset(multi, 0, sizeof(*multi));
+    multi->count = count;
+    for (int i = 0; i < count; i++) {
+        multi->machines[i] = machines[i];
+    }
+    return buildProduct(multi);
+}
+
+void dfaMultiFree(DfaMulti *multi) {
+    if (multi->product.next)
+        dfaFree(&multi->product);
+    free(multi->verdicts);
+    multi->verdicts = NULL;
+}
+
+void dfaMultiStart(const DfaMulti *multi, DfaMultiCursor *cursor) {
+    cursor->product = 0;
+    for (int i = 0; i < multi->count; i++) {
+        cursor->lanes[i] = multi->machines[i]->start;
+    }
+}
+
+void dfaMultiRun(const DfaMulti *multi, DfaMultiCursor *cursor, const char *input, size_t len) {
+    if (multi->product.num_states > 0) {
+        dfaRunUntilSink(&multi->product, &cursor->product, input, len);
+        return;
+    }
+
+    // Lane mode: one pass over the bytes, every machine stepped per byte
+    const unsigned char *p = (const unsigned char *)input;
+    const DfaState *next[DFA_MULTI_MAX];
+    DfaState lanes[DFA_MULTI_MAX];
+    int k = multi->count;
+
+    for (int i = 0; i < k; i++) {
+        next[i] = multi->machines[i]->next;
+        lanes[i] = cursor->lanes[i];
+    }
+    for (size_t done = 0; done < len;) {
+        size_t block = len - done < LANE_BLOCK ? len - done : LANE_BLOCK;
+        for (size_t j = done; j < done + block; j++) {
+            for (int i = 0; i < k; i++) {
+                lanes[i] = next[i][(size_t)lanes[i] * DFA_SYMBOLS + p[j]];
+            }
+        }
+        done += block;
+
+        // Stop once every machine is in a sink
+        int i = 0;
+        while (i < k && dfaIsSink(multi->machines[i], lanes[i]))
+            i++;
+        if (i == k)
+            break;
+    }
+    memcpy(cursor->lanes, lanes, (size_t)k * sizeof(DfaState));
+}
+
+uint32_t dfaMultiVerdicts(const DfaMulti *multi, const DfaMultiCursor *cursor) {
+    if (multi->product.num_states > 0)
+        return multi->verdicts[cursor->product];
+
+    uint32_t bits = 0;
+    for (int i = 0; i < multi->count; i++) {
+        if (dfaIsAccepting(multi->machines[i], cursor->lanes[i]))
+            bits |= 1u << i;
+    }
+    return bits;
+}
+
+uint32_t dfaMultiAccepts(const DfaMulti *multi, const char *input, size_t len) {
+    DfaMultiCursor cursor;
+    dfaMultiStart(multi, &cursor);
+    dfaMultiRun(multi, &cursor, input, len);
+    return dfaMultiVerdicts(multi, &cursor);
+}
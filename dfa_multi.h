@@ -0,0 +1,97 @@
+#ifndef DFA_MULTI_H
+#define DFA_MULTI_H
+
+#include <stdint.h>
+
+#include "dfa_engine.h"
+
+#define DFA_MULTI_MAX 32               // machines per set, one verdict bit each
+#define DFA_MULTI_MAX_PRODUCT 4096     // larger products run as separate lanes
+
+/*
+ * A set of DFAs evaluated together in one pass over the input
+ *
+ * When the reachable part of the product automaton has at most
+ * DFA_MULTI_MAX_PRODUCT states it is built as one table, so each byte costs
+ * a single lookup however many machines there are. Otherwise every byte
+ * steps a tuple of states, one lane per machine. Either way the input is
+ * read once.
+ *
+ * @param count - Number of machines
+ * @param machines - The machines, not owned
+ * @param product - Product table, num_states 0 in lane mode
+ * @param verdicts - Accept bitmask of each product state
+ */
+typedef struct {
+    int count;
+    const Dfa *machines[DFA_MULTI_MAX];
+    Dfa product;
+    uint32_t *verdicts;
+} DfaMulti;
+
+/*
+ * Position of a run through a DfaMulti, for input that arrives in pieces
+ *
+ * @param product - Current product state (product mode)
+ * @param lanes - Current state of each machine (lane mode)
+ */
+typedef struct {
+    DfaState product;
+    DfaState lanes[DFA_MULTI_MAX];
+} DfaMultiCursor;
+
+/*
+ * Prepare a set of machines, building the product table if it is small
+ *
+ * @param multi - The set to initialise
+ * @param machines - The machines, which must outlive the set
+ * @param count - Number of machines, 1 .. DFA_MULTI_MAX
+ * @return Number of product states, or 0 if the set runs in lane mode
+ */
+int dfaMultiInit(DfaMulti *multi, const Dfa *const machines[], int count);
+
+/*
+ * Free the product table of a set
+ *
+ * @param multi - The set to free
+ */
+void dfaMultiFree(DfaMulti *multi);
+
+/*
+ * Put a cursor at the start states of every machine
+ *
+ * @param multi - The set
+ * @param cursor - The cursor to reset
+ */
+void dfaMultiStart(const DfaMulti *multi, DfaMultiCursor *cursor);
+
+/*
+ * Advance every machine over a block of input
+ *
+ * @param multi - The set
+ * @param cursor - The cursor to advance
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ */
+void dfaMultiRun(const DfaMulti *multi, DfaMultiCursor *cursor, const char *input, size_t len);
+
+/*
+ * Verdicts at the cursor
+ *
+ * @param multi - The set
+ * @param cursor - The cursor
+ * @return Bit i set if machine i is in an accept state
+ */
+uint32_t dfaMultiVerdicts(const DfaMulti *multi, const DfaMultiCursor *cursor);
+
+/*
+ * Membership test of one string against every machine
+ *
+ * @param multi - The set
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Bit i set if machine i accepts the input
+ */
+uint32_t dfaMultiAccepts(const DfaMulti *multi, const char *input, size_t len);
+
+#endif
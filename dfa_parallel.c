@@ -0,0 +1,74 @@
+#include <stdlib.h>
+
+#include "dfa_parallel.h"
+#include "parallel_chunks.h"
+
+#define MERGE_BLOCK 4096 // bytes between lane-convergence checks
+
+/*
+ * One chunk of speculative work
+ *
+ * @param lanes - Where the chunk is and the state of each lane
+ * @param dfa - The DFA
+ */
+typedef struct {
+    ChunkLanes lanes;
+    const Dfa *dfa;
+} Chunk;
+
+static void *runChunk(void *arg) {
+    Chunk *chunk = arg;
+    ChunkLanes *lanes = &chunk->lanes;
+    size_t pos = 0;
+
+    while (pos < lanes->len && lanes->num_lanes > 1) {
+        size_t n = lanes->len - pos < MERGE_BLOCK ? lanes->len - pos : MERGE_BLOCK;
+        bool all_sinks = true;
+        for (int i = 0; i < lanes->num_lanes; i++) {
+            if (dfaIsSink(chunk->dfa, (DfaState)lanes->lane[i]))
+                continue;
+            lanes->lane[i] = dfaRun(chunk->dfa, (DfaState)lanes->lane[i], lanes->input + pos, n);
+            all_sinks = all_sinks && dfaIsSink(chunk->dfa, (DfaState)lanes->lane[i]);
+        }
+        pos += n;
+        parallelMergeLanes(lanes, chunk->dfa->num_states);
+        if (all_sinks)
+            return NULL; // the rest of the chunk cannot move any lane
+    }
+    // all start states have converged, finish with a single walk
+    if (pos < lanes->len) {
+        DfaState state = (DfaState)lanes->lane[0];
+        dfaRunUntilSink(chunk->dfa, &state, lanes->input + pos, lanes->len - pos);
+        lanes->lane[0] = state;
+    }
+    return NULL;
+}
+
+DfaState dfaRunParallel(const Dfa *dfa, DfaState state, const char *input, size_t len, int num_threads) {
+    int num_chunks = parallelChunkCount(len, DFA_PARALLEL_MIN_CHUNK, num_threads);
+    if (num_chunks < 2 || dfa->num_states > DFA_PARALLEL_MAX_LANES) {
+        dfaRunUntilSink(dfa, &state, input, len);
+        return state;
+    }
+
+    Chunk *chunks = parallelSplit(input, len, num_chunks, dfa->num_states, sizeof(Chunk));
+    for (int t = 0; t < num_chunks; t++) {
+        chunks[t].dfa = dfa;
+    }
+    // the first chunk knows its real start state, no speculation needed
+    chunks[0].lanes.num_lanes = 1;
+    chunks[0].lanes.lane[0] = state;
+    for (int s = 0; s < dfa->num_states; s++) {
+        chunks[0].lanes.owner[s] = 0;
+    }
+    parallelRun(chunks, num_chunks, sizeof(Chunk), runChunk);
+
+    // compose the per-chunk state maps left to right
+    state = (DfaState)chunks[0].lanes.lane[0];
+    for (int t = 1; t < num_chunks; t++) {
+        state = (DfaState)chunks[t].lanes.lane[chunks[t].lanes.owner[state]];
+    }
+
+    free(chunks);
+    return state;
+}
@@ -0,0 +1,29 @@
+#ifndef DFA_PARALLEL_H
+#define DFA_PARALLEL_H
+
+#include "dfa_engine.h"
+#include "parallel_chunks.h"
+
+#define DFA_PARALLEL_MIN_CHUNK (1u << 20)           // below 1 MiB per thread, stay sequential
+#define DFA_PARALLEL_MAX_LANES PARALLEL_MAX_LANES // one lane per state
+
+/*
+ * Speculative multi-threaded DFA run
+ *
+ * Splits the input into one chunk per thread. Every chunk but the first is
+ * run from all DFA states at once; lanes that reach the same state are
+ * merged, so a chunk usually collapses to a single lane after a few bytes.
+ * The per-chunk state maps are then composed in order. A chunk stops early
+ * once all of its lanes are in sinks. Falls back to dfaRunUntilSink() for
+ * short inputs or machines with too many states.
+ *
+ * @param dfa - The DFA
+ * @param state - The state to start from
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @param num_threads - Threads to use, 0 for parallelDefaultThreads()
+ * @return The state after consuming the whole input
+ */
+DfaState dfaRunParallel(const Dfa *dfa, DfaState state, const char *input, size_t len, int num_threads);
+
+#endif
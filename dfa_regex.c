@@ -0,0 +1,964 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dfa_regex.h"
+
+#define MAX_NESTING 1000 // groups and repeats around an atom, bounds the recursion
+
+typedef uint8_t ByteSet[DFA_SYMBOLS / 8];
+
+typedef enum {
+    NODE_EMPTY,  // matches the empty string
+    NODE_SET,    // one byte from sets[set]
+    NODE_CONCAT, // left then right
+    NODE_ALT,    // left or right
+    NODE_REPEAT  // left, min to max times (max -1 for no limit)
+} NodeType;
+
+typedef struct {
+    NodeType type;
+    int left;
+    int right;
+    int set;
+    int min;
+    int max;
+} Node;
+
+/*
+ * Thompson NFA state: a byte-set edge to out[0] if set >= 0, otherwise up
+ * to two epsilon edges (-1 where absent)
+ */
+typedef struct {
+    int set;
+    int out[2];
+} NfaState;
+
+typedef struct {
+    const char *pattern;
+    const char *p;
+    char *error;
+    size_t error_size;
+    int depth;
+
+    Node *nodes;
+    int num_nodes;
+    int node_cap;
+    ByteSet *sets;
+    int num_sets;
+    int set_cap;
+
+    NfaState *nfa;
+    int num_nfa;
+    int nfa_cap;
+    int start;  // entry state of the NFA
+    int accept; // final state of the NFA
+} Regex;
+
+static void *xrealloc(void *p, size_t size) {
+    p = realloc(p, size);
+    if (!p) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    return p;
+}
+
+static int fail(Regex *re, const char *reason) {
+    snprintf(re->error, re->error_size, "position %d: %s", (int)(re->p - re->pattern) + 1, reason);
+    return -1;
+}
+
+static inline bool setHas(const ByteSet set, int c) {
+    return (set[c >> 3] >> (c & 7)) & 1;
+}
+
+static inline void setAdd(ByteSet set, int c) {
+    set[c >> 3] |= (uint8_t)(1u << (c & 7));
+}
+
+/* ---------------------------------------------------------------- parser */
+
+static int newNode(Regex *re, NodeType type, int left, int right) {
+    if (re->num_nodes == re->node_cap) {
+        re->node_cap = re->node_cap ? 2 * re->node_cap : 64;
+        re->nodes = xrealloc(re->nodes, (size_t)re->node_cap * sizeof(Node));
+    }
+    Node *node = &re->nodes[re->num_nodes];
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->left = left;
+    node->right = right;
+    return re->num_nodes++;
+}
+
+static int newSet(Regex *re) {
+    if (re->num_sets == re->set_cap) {
+        re->set_cap = re->set_cap ? 2 * re->set_cap : 32;
+        re->sets = xrealloc(re->sets, (size_t)re->set_cap * sizeof(ByteSet));
+    }
+    memset(re->sets[re->num_sets], 0, sizeof(ByteSet));
+    return re->num_sets++;
+}
+
+static int hexDigit(int c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/*
+ * Add the bytes of a \d \s \w class (or its negation) to a set
+ *
+ * @return false if c does not name a class
+ */
+static bool addClassEscape(ByteSet set, int c) {
+    ByteSet members;
+    memset(members, 0, sizeof(members));
+    switch (c | 0x20) {
+    case 'd':
+        for (int b = '0'; b <= '9'; b++)
+            setAdd(members, b);
+        break;
+    case 's':
+        for (const char *s = " \t\n\r\f\v"; *s; s++)
+            setAdd(members, (unsigned char)*s);
+        break;
+    case 'w':
+        for (int b = 0; b < DFA_SYMBOLS; b++) {
+            if ((b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || b == '_')
+                setAdd(members, b);
+        }
+        break;
+    default:
+        return false;
+    }
+    bool negated = c >= 'A' && c <= 'Z';
+    for (int i = 0; i < (int)sizeof(ByteSet); i++) {
+        set[i] |= negated ? (uint8_t)~members[i] : members[i];
+    }
+    return true;
+}
+
+/*
+ * Read one escaped byte after a backslash
+ *
+ * @return The byte, or -1 after setting the error
+ */
+static int parseEscape(Regex *re) {
+    int c = (unsigned char)*re->p;
+    if (c == '\0')
+        return fail(re, "trailing backslash");
+    re->p++;
+    switch (c) {
+    case 'n':
+        return '\n';
+    case 't':
+        return '\t';
+    case 'r':
+        return '\r';
+    case 'x': {
+        int high = hexDigit((unsigned char)re->p[0]);
+        int low = high < 0 ? -1 : hexDigit((unsigned char)re->p[1]);
+        if (low < 0)
+            return fail(re, "\\x needs two hex digits");
+        re->p += 2;
+        return high << 4 | low;
+    }
+    default:
+        return c;
+    }
+}
+
+/*
+ * Bracket expression, the '[' already consumed
+ */
+static int parseClass(Regex *re) {
+    int set = newSet(re);
+    bool negated = *re->p == '^';
+    if (negated)
+        re->p++;
+
+    bool first = true;
+    while (*re->p != ']' || first) {
+        first = false;
+        if (*re->p == '\0')
+            return fail(re, "missing ]");
+
+        int low = (unsigned char)*re->p++;
+        if (low == '\\') {
+            if (addClassEscape(re->sets[set], (unsigned char)*re->p)) {
+                re->p++;
+                continue;
+            }
+            if ((low = parseEscape(re)) < 0)
+                return -1;
+        }
+        int high = low;
+        if (re->p[0] == '-' && re->p[1] != ']' && re->p[1] != '\0') {
+            re->p++;
+            high = (unsigned char)*re->p++;
+            if (high == '\\' && (high = parseEscape(re)) < 0)
+                return -1;
+            if (high < low)
+                return fail(re, "range out of order");
+        }
+        for (int c = low; c <= high; c++) {
+            setAdd(re->sets[set], c);
+        }
+    }
+    re->p++;
+
+    if (negated) {
+        for (int i = 0; i < (int)sizeof(ByteSet); i++) {
+            re->sets[set][i] = (uint8_t)~re->sets[set][i];
+        }
+    }
+    int node = newNode(re, NODE_SET, -1, -1);
+    re->nodes[node].set = set;
+    return node;
+}
+
+static int parseAlternation(Regex *re);
+
+static int parseAtom(Regex *re) {
+    int c = (unsigned char)*re->p++;
+    int set;
+
+    switch (c) {
+    case '(': {
+        if (++re->depth > MAX_NESTING)
+            return fail(re, "groups nested too deeply");
+        int inner = parseAlternation(re);
+        if (inner < 0)
+            return -1;
+        if (*re->p != ')')
+            return fail(re, "missing )");
+        re->p++;
+        re->depth--;
+        return inner;
+    }
+    case '[':
+        return parseClass(re);
+    case '.':
+        set = newSet(re);
+        memset(re->sets[set], 0xFF, sizeof(ByteSet));
+        break;
+    case '\\':
+        set = newSet(re);
+        if (addClassEscape(re->sets[set], (unsigned char)*re->p)) {
+            re->p++;
+            break;
+        }
+        if ((c = parseEscape(re)) < 0)
+            return -1;
+        setAdd(re->sets[set], c);
+        break;
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+        re->p--;
+        return fail(re, "nothing to repeat");
+    default:
+        set = newSet(re);
+        setAdd(re->sets[set], c);
+        break;
+    }
+    int node = newNode(re, NODE_SET, -1, -1);
+    re->nodes[node].set = set;
+    return node;
+}
+
+static int parseNumber(Regex *re) {
+    int value = -1;
+    while (*re->p >= '0' && *re->p <= '9') {
+        value = (value < 0 ? 0 : value * 10) + (*re->p++ - '0');
+        if (value > REGEX_MAX_REPEAT)
+            return -2;
+    }
+    return value;
+}
+
+/*
+ * {n}, {n,} or {n,m}, the '{' already consumed
+ */
+static int parseBounds(Regex *re, int *min, int *max) {
+    char reason[64];
+    *min = parseNumber(re);
+    *max = *min;
+    if (*re->p == ',') {
+        re->p++;
+        *max = *re->p == '}' ? -1 : parseNumber(re);
+    }
+    if (*min == -2 || *max == -2) {
+        snprintf(reason, sizeof(reason), "repeat count above %d", REGEX_MAX_REPEAT);
+        return fail(re, reason);
+    }
+    if (*min < 0 || *re->p != '}' || (*max != -1 && *max < 0))
+        return fail(re, "bad repeat, expected {n}, {n,} or {n,m}");
+    if (*max != -1 && *max < *min)
+        return fail(re, "repeat bounds out of order");
+    re->p++;
+    return 0;
+}
+
+static int parseRepeat(Regex *re) {
+    int node = parseAtom(re);
+    int depth = re->depth;
+
+    while (node >= 0 && (*re->p == '*' || *re->p == '+' || *re->p == '?' || *re->p == '{')) {
+        int min = 0, max = -1;
+        // each operator nests the atom one level deeper, like a group
+        if (++re->depth > MAX_NESTING)
+            return fail(re, "repeats nested too deeply");
+        char op = *re->p++;
+        if (op == '+')
+            min = 1;
+        else if (op == '?')
+            max = 1;
+        else if (op == '{' && parseBounds(re, &min, &max) != 0)
+            return -1;
+        node = newNode(re, NODE_REPEAT, node, -1);
+        re->nodes[node].min = min;
+        re->nodes[node].max = max;
+    }
+    re->depth = depth;
+    return node;
+}
+
+static int parseConcatenation(Regex *re) {
+    int node = -1;
+
+    while (*re->p != '\0' && *re->p != '|' && *re->p != ')') {
+        int next = parseRepeat(re);
+        if (next < 0)
+            return -1;
+        node = node < 0 ? next : newNode(re, NODE_CONCAT, node, next);
+    }
+    return node < 0 ? newNode(re, NODE_EMPTY, -1, -1) : node;
+}
+
+static int parseAlternation(Regex *re) {
+    int node = parseConcatenation(re);
+
+    while (node >= 0 && *re->p == '|') {
+        re->p++;
+        int next = parseConcatenation(re);
+        if (next < 0)
+            return -1;
+        node = newNode(re, NODE_ALT, node, next);
+    }
+    return node;
+}
+
+/* ------------------------------------------------------- Thompson NFA */
+
+static int newNfaState(Regex *re, int set) {
+    if (re->num_nfa == re->nfa_cap) {
+        re->nfa_cap = re->nfa_cap ? 2 * re->nfa_cap : 256;
+        re->nfa = xrealloc(re->nfa, (size_t)re->nfa_cap * sizeof(NfaState));
+    }
+    re->nfa[re->num_nfa].set = set;
+    re->nfa[re->num_nfa].out[0] = -1;
+    re->nfa[re->num_nfa].out[1] = -1;
+    return re->num_nfa++;
+}
+
+/*
+ * Add an epsilon edge from an epsilon state
+ */
+static void link(Regex *re, int from, int to) {
+    NfaState *state = &re->nfa[from];
+    state->out[state->out[0] < 0 ? 0 : 1] = to;
+}
+
+/*
+ * Operands of a chain of CONCAT or ALT nodes, left to right
+ *
+ * The parser builds abc and a|b|c as left-deep chains as long as the
+ * pattern, so emit() walks them in a loop rather than recursing down them.
+ *
+ * @param n - The node at the top of the chain
+ * @param ops - Receives the operands, to be freed by the caller
+ * @return Number of operands
+ */
+static int chainOperands(const Regex *re, int n, int **ops) {
+    NodeType type = re->nodes[n].type;
+    int count = 1;
+    int m;
+
+    for (m = n; re->nodes[m].type == type; m = re->nodes[m].left) {
+        count++;
+    }
+    *ops = xrealloc(NULL, (size_t)count * sizeof(int));
+    int i = count;
+    for (m = n; re->nodes[m].type == type; m = re->nodes[m].left) {
+        (*ops)[--i] = re->nodes[m].right;
+    }
+    (*ops)[0] = m;
+    return count;
+}
+
+/*
+ * Emit the NFA fragment for a node
+ *
+ * @param start - Receives the fragment's entry state
+ * @return The fragment's exit, an epsilon state with no edges yet, or -1
+ *         if the NFA grew past REGEX_MAX_NFA_STATES
+ */
+static int emit(Regex *re, int n, int *start) {
+    const Node node = re->nodes[n];
+    int first, end, inner, count;
+    int *ops, *splits;
+
+    if (re->num_nfa > REGEX_MAX_NFA_STATES)
+        return -1;
+
+    switch (node.type) {
+    case NODE_EMPTY:
+        *start = end = newNfaState(re, -1);
+        return end;
+    case NODE_SET:
+        end = newNfaState(re, -1);
+        *start = newNfaState(re, node.set);
+        re->nfa[*start].out[0] = end;
+        return end;
+    case NODE_CONCAT:
+        count = chainOperands(re, n, &ops);
+        end = emit(re, ops[0], start);
+        for (int i = 1; i < count && end >= 0; i++) {
+            if ((inner = emit(re, ops[i], &first)) >= 0)
+                link(re, end, first);
+            end = inner;
+        }
+        free(ops);
+        return end;
+    case NODE_ALT:
+        // one split state per |, outermost first, each joining the
+        // alternatives to its left with the one to its right
+        count = chainOperands(re, n, &ops);
+        if (count - 1 > REGEX_MAX_NFA_STATES - re->num_nfa) {
+            free(ops);
+            return -1;
+        }
+        splits = xrealloc(NULL, (size_t)count * sizeof(int));
+        for (int i = count - 1; i > 0; i--) {
+            splits[i] = newNfaState(re, -1);
+        }
+        end = emit(re, ops[0], start);
+        for (int i = 1; i < count && end >= 0; i++) {
+            int exit = end;
+            link(re, splits[i], *start);
+            end = newNfaState(re, -1);
+            link(re, exit, end);
+            if ((exit = emit(re, ops[i], &first)) < 0) {
+                end = -1;
+                break;
+            }
+            link(re, splits[i], first);
+            link(re, exit, end);
+            *start = splits[i];
+        }
+        free(ops);
+        free(splits);
+        return end;
+    case NODE_REPEAT:
+        // min required copies, then either a loop or max - min optional ones
+        *start = end = newNfaState(re, -1);
+        for (int i = 0; i < node.min; i++) {
+            if ((inner = emit(re, node.left, &first)) < 0)
+                return -1;
+            link(re, end, first);
+            end = inner;
+        }
+        if (node.max < 0) {
+            int loop = end;
+            if ((inner = emit(re, node.left, &first)) < 0)
+                return -1;
+            end = newNfaState(re, -1);
+            link(re, loop, first);
+            link(re, loop, end);
+            link(re, inner, loop);
+            return end;
+        }
+        if (node.max > node.min) {
+            int exit = newNfaState(re, -1);
+            for (int i = node.min; i < node.max; i++) {
+                if ((inner = emit(re, node.left, &first)) < 0)
+                    return -1;
+                link(re, end, first);
+                link(re, end, exit);
+                end = inner;
+            }
+            link(re, end, exit);
+            end = exit;
+        }
+        return end;
+    }
+    return -1;
+}
+
+/*
+ * Parse a pattern and build its Thompson NFA
+ *
+ * @return 0 on success, -1 with the error set
+ */
+static int buildNfa(Regex *re, const char *pattern, char *error, size_t error_size) {
+    memset(re, 0, sizeof(*re));
+    re->pattern = pattern;
+    re->p = pattern;
+    re->error = error;
+    re->error_size = error_size;
+
+    int root = parseAlternation(re);
+    if (root < 0)
+        return -1;
+    if (*re->p == ')')
+        return fail(re, "unmatched )");
+    re->accept = emit(re, root, &re->start);
+    if (re->accept < 0 || re->num_nfa > REGEX_MAX_NFA_STATES) {
+        snprintf(error, error_size, "pattern needs more than %d NFA states", REGEX_MAX_NFA_STATES);
+        return -1;
+    }
+    return 0;
+}
+
+static void freeRegex(Regex *re) {
+    free(re->nfa);
+    free(re->sets);
+    free(re->nodes);
+}
+
+/* -------------------------------------------------- subset construction */
+
+typedef struct {
+    const Regex *re;
+    int limit;           // most DFA states to create
+
+    int *stack;          // closure work list
+    unsigned *seen;      // generation stamp per NFA state
+    unsigned generation;
+    int *members;        // scratch set under construction
+    int num_members;
+
+    int *pool;           // the NFA states of every DFA state, back to back
+    size_t pool_len;
+    size_t pool_cap;
+    size_t *offsets;     // DFA state -> start in pool, offsets[n] = pool_len
+    int num_states;
+    int state_cap;
+
+    int *slots;          // hash table of DFA state id + 1, 0 if empty
+    int num_slots;
+} Subsets;
+
+static int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void rehash(Subsets *sub);
+
+static void subsetsInit(Subsets *sub, const Regex *re, int limit) {
+    memset(sub, 0, sizeof(*sub));
+    sub->re = re;
+    sub->limit = limit;
+    sub->stack = xrealloc(NULL, (size_t)re->num_nfa * sizeof(int));
+    sub->members = xrealloc(NULL, (size_t)re->num_nfa * sizeof(int));
+    sub->seen = calloc((size_t)re->num_nfa, sizeof(unsigned));
+    sub->state_cap = 256;
+    sub->offsets = xrealloc(NULL, (size_t)sub->state_cap * sizeof(size_t));
+    sub->offsets[0] = 0;
+    if (!sub->seen) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    rehash(sub);
+}
+
+/*
+ * Forget every DFA state, keeping the buffers
+ */
+static void subsetsReset(Subsets *sub) {
+    sub->num_states = 0;
+    sub->pool_len = 0;
+    memset(sub->slots, 0, (size_t)sub->num_slots * sizeof(int));
+}
+
+static void subsetsFree(Subsets *sub) {
+    free(sub->slots);
+    free(sub->offsets);
+    free(sub->pool);
+    free(sub->seen);
+    free(sub->members);
+    free(sub->stack);
+}
+
+/*
+ * Follow epsilon edges from the states in members, keeping only states
+ * with a byte edge and the accept state, in sorted order
+ */
+static void closure(Subsets *sub) {
+    int top = 0;
+    int kept = 0;
+
+    sub->generation++;
+    for (int i = 0; i < sub->num_members; i++) {
+        if (sub->seen[sub->members[i]] != sub->generation) {
+            sub->seen[sub->members[i]] = sub->generation;
+            sub->stack[top++] = sub->members[i];
+        }
+    }
+    while (top > 0) {
+        int s = sub->stack[--top];
+        const NfaState *state = &sub->re->nfa[s];
+        if (state->set >= 0 || s == sub->re->accept) {
+            sub->members[kept++] = s;
+            continue;
+        }
+        for (int e = 0; e < 2; e++) {
+            int t = state->out[e];
+            if (t >= 0 && sub->seen[t] != sub->generation) {
+                sub->seen[t] = sub->generation;
+                sub->stack[top++] = t;
+            }
+        }
+    }
+    sub->num_members = kept;
+    qsort(sub->members, (size_t)kept, sizeof(int), compareInts);
+}
+
+/*
+ * Members of the start state
+ */
+static void startSet(Subsets *sub) {
+    sub->members[0] = sub->re->start;
+    sub->num_members = 1;
+    closure(sub);
+}
+
+/*
+ * Members of the state a DFA state moves to on a byte
+ */
+static void move(Subsets *sub, int id, int c) {
+    const Regex *re = sub->re;
+    sub->num_members = 0;
+    for (size_t i = sub->offsets[id]; i < sub->offsets[id + 1]; i++) {
+        const NfaState *state = &re->nfa[sub->pool[i]];
+        if (state->set >= 0 && setHas(re->sets[state->set], c))
+            sub->members[sub->num_members++] = state->out[0];
+    }
+    closure(sub);
+}
+
+static bool hasAccept(const Subsets *sub, int id) {
+    size_t count = sub->offsets[id + 1] - sub->offsets[id];
+    return bsearch(&sub->re->accept, &sub->pool[sub->offsets[id]], count, sizeof(int), compareInts) != NULL;
+}
+
+static unsigned hashMembers(const int *members, int count) {
+    unsigned h = 2166136261u;
+    for (int i = 0; i < count; i++) {
+        h = (h ^ (unsigned)members[i]) * 16777619u;
+    }
+    return h;
+}
+
+static bool sameMembers(const Subsets *sub, int id) {
+    size_t len = sub->offsets[id + 1] - sub->offsets[id];
+    return len == (size_t)sub->num_members &&
+           memcmp(&sub->pool[sub->offsets[id]], sub->members, len * sizeof(int)) == 0;
+}
+
+static void rehash(Subsets *sub) {
+    sub->num_slots = sub->num_slots ? 2 * sub->num_slots : 1024;
+    free(sub->slots);
+    sub->slots = calloc((size_t)sub->num_slots, sizeof(int));
+    if (!sub->slots) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int id = 0; id < sub->num_states; id++) {
+        const int *members = &sub->pool[sub->offsets[id]];
+        unsigned h = hashMembers(members, (int)(sub->offsets[id + 1] - sub->offsets[id]));
+        h &= (unsigned)sub->num_slots - 1;
+        while (sub->slots[h])
+            h = (h + 1) & ((unsigned)sub->num_slots - 1);
+        sub->slots[h] = id + 1;
+    }
+}
+
+/*
+ * Find the DFA state for the current members, adding it if it is new
+ *
+ * @return The state id, or -1 if that would exceed the state limit
+ */
+static int intern(Subsets *sub) {
+    unsigned mask = (unsigned)sub->num_slots - 1;
+    unsigned h = hashMembers(sub->members, sub->num_members) & mask;
+    while (sub->slots[h]) {
+        if (sameMembers(sub, sub->slots[h] - 1))
+            return sub->slots[h] - 1;
+        h = (h + 1) & mask;
+    }
+    if (sub->num_states == sub->limit)
+        return -1;
+
+    if (sub->pool_len + (size_t)sub->num_members > sub->pool_cap) {
+        while (sub->pool_len + (size_t)sub->num_members > sub->pool_cap)
+            sub->pool_cap = sub->pool_cap ? 2 * sub->pool_cap : 4096;
+        sub->pool = xrealloc(sub->pool, sub->pool_cap * sizeof(int));
+    }
+    if (sub->num_states + 1 == sub->state_cap) {
+        sub->state_cap *= 2;
+        sub->offsets = xrealloc(sub->offsets, (size_t)sub->state_cap * sizeof(size_t));
+    }
+    memcpy(&sub->pool[sub->pool_len], sub->members, (size_t)sub->num_members * sizeof(int));
+    sub->pool_len += (size_t)sub->num_members;
+    int id = sub->num_states++;
+    sub->offsets[sub->num_states] = sub->pool_len;
+    sub->slots[h] = id + 1;
+
+    if (2 * sub->num_states > sub->num_slots)
+        rehash(sub);
+    return id;
+}
+
+/*
+ * Group bytes that every set treats alike; the DFA needs one column per group
+ *
+ * @return Number of classes
+ */
+static int byteClasses(const Regex *re, int *class_of, int *representative) {
+    int num_classes = 1;
+    memset(class_of, 0, DFA_SYMBOLS * sizeof(int));
+
+    // Split every class by membership in each set in turn
+    for (int s = 0; s < re->num_sets; s++) {
+        int renumber[2 * DFA_SYMBOLS]; // (old class, member?) -> new class
+        for (int k = 0; k < 2 * num_classes; k++) {
+            renumber[k] = -1;
+        }
+        num_classes = 0;
+        for (int c = 0; c < DFA_SYMBOLS; c++) {
+            int key = 2 * class_of[c] + setHas(re->sets[s], c);
+            if (renumber[key] < 0)
+                renumber[key] = num_classes++;
+            class_of[c] = renumber[key];
+        }
+    }
+    for (int c = DFA_SYMBOLS - 1; c >= 0; c--) {
+        representative[class_of[c]] = c;
+    }
+    return num_classes;
+}
+
+static int subsetConstruction(const Regex *re, Dfa *dfa) {
+    int class_of[DFA_SYMBOLS], representative[DFA_SYMBOLS];
+    int num_classes = byteClasses(re, class_of, representative);
+
+    Subsets sub;
+    subsetsInit(&sub, re, DFA_MAX_STATES);
+    DfaState *next = NULL; // next[state * num_classes + class]
+    size_t next_cap = 0;
+    int result = 0;
+
+    startSet(&sub);
+    intern(&sub);
+    for (int id = 0; id < sub.num_states && result == 0; id++) {
+        if ((size_t)sub.num_states * num_classes > next_cap) {
+            next_cap = 2 * (size_t)sub.num_states * num_classes;
+            next = xrealloc(next, next_cap * sizeof(DfaState));
+        }
+        for (int k = 0; k < num_classes; k++) {
+            move(&sub, id, representative[k]);
+            int target = intern(&sub);
+            if (target < 0) {
+                snprintf(re->error, re->error_size, "pattern needs more than %d DFA states", DFA_MAX_STATES);
+                result = -2;
+                break;
+            }
+            next[(size_t)id * num_classes + k] = (DfaState)target;
+        }
+    }
+
+    if (result == 0) {
+        dfaInit(dfa, sub.num_states, 0, 0);
+        for (int id = 0; id < sub.num_states; id++) {
+            for (int c = 0; c < DFA_SYMBOLS; c++) {
+                dfaSetTransition(dfa, (DfaState)id, (unsigned char)c, next[(size_t)id * num_classes + class_of[c]]);
+            }
+            if (hasAccept(&sub, id))
+                dfaSetAccept(dfa, (DfaState)id, true);
+        }
+    }
+
+    free(next);
+    subsetsFree(&sub);
+    return result;
+}
+
+int regexCompile(const char *pattern, Dfa *dfa, char *error, size_t error_size) {
+    Regex re;
+    int result = buildNfa(&re, pattern, error, error_size);
+    if (result == 0)
+        result = subsetConstruction(&re, dfa);
+    freeRegex(&re);
+    return result;
+}
+
+/* ------------------------------------------------------------ lazy DFA */
+
+struct RegexLazyCore {
+    Regex re;
+    Subsets sub;
+    int representative[DFA_SYMBOLS];
+    int *start_members; // the start state's NFA states, kept across flushes
+    int num_start;
+    int *saved;         // the current state's NFA states during a flush
+};
+
+/*
+ * Set up the row of a state the cache has just added
+ */
+static void lazyAdded(RegexLazy *lazy, int id) {
+    Subsets *sub = &lazy->core->sub;
+    for (int k = 0; k < lazy->num_classes; k++) {
+        lazy->next[(size_t)id * lazy->num_classes + k] = -1;
+    }
+    lazy->accept[id] = hasAccept(sub, id);
+    if (sub->offsets[id + 1] == sub->offsets[id])
+        lazy->dead = id;
+}
+
+/*
+ * Intern the current members, setting up the row if the state is new
+ */
+static int lazyIntern(RegexLazy *lazy) {
+    Subsets *sub = &lazy->core->sub;
+    int before = sub->num_states;
+    int id = intern(sub);
+    if (id >= before)
+        lazyAdded(lazy, id);
+    return id;
+}
+
+/*
+ * Empty the cache, keeping only the start state and the current one
+ *
+ * @return The current state's new id
+ */
+static int lazyFlush(RegexLazy *lazy, int state) {
+    struct RegexLazyCore *core = lazy->core;
+    Subsets *sub = &core->sub;
+    int count = (int)(sub->offsets[state + 1] - sub->offsets[state]);
+
+    memcpy(core->saved, &sub->pool[sub->offsets[state]], (size_t)count * sizeof(int));
+    subsetsReset(sub);
+    lazy->dead = -1;
+    lazy->flushes++;
+
+    memcpy(sub->members, core->start_members, (size_t)core->num_start * sizeof(int));
+    sub->num_members = core->num_start;
+    lazy->start = lazyIntern(lazy);
+    memcpy(sub->members, core->saved, (size_t)count * sizeof(int));
+    sub->num_members = count;
+    return lazyIntern(lazy);
+}
+
+/*
+ * Build a missing transition
+ *
+ * @param state - The source state, receives its new id if the cache was flushed
+ * @return The target state
+ */
+static int lazyTransition(RegexLazy *lazy, int *state, int k) {
+    struct RegexLazyCore *core = lazy->core;
+    Subsets *sub = &core->sub;
+
+    if (sub->num_states >= lazy->max_states || sub->pool_len > lazy->pool_budget)
+        *state = lazyFlush(lazy, *state);
+    move(sub, *state, core->representative[k]);
+    int target = lazyIntern(lazy);
+    lazy->next[(size_t)*state * lazy->num_classes + k] = target;
+    lazy->built++;
+    return target;
+}
+
+int regexLazyInit(RegexLazy *lazy, const char *pattern, size_t cache_bytes, char *error, size_t error_size) {
+    memset(lazy, 0, sizeof(*lazy));
+    struct RegexLazyCore *core = calloc(1, sizeof(*core));
+    if (!core) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    if (buildNfa(&core->re, pattern, error, error_size) != 0) {
+        freeRegex(&core->re);
+        free(core);
+        return -1;
+    }
+    lazy->core = core;
+
+    int class_of[DFA_SYMBOLS];
+    lazy->num_classes = byteClasses(&core->re, class_of, core->representative);
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        lazy->class_of[c] = (uint8_t)class_of[c];
+    }
+
+    // Half the budget for transition rows, half for the NFA state sets
+    size_t row = (size_t)lazy->num_classes * sizeof(int32_t) + sizeof(size_t) + 1;
+    size_t states = cache_bytes / 2 / row;
+    lazy->max_states = states < REGEX_LAZY_MIN_STATES ? REGEX_LAZY_MIN_STATES
+                     : states > DFA_MAX_STATES       ? DFA_MAX_STATES
+                                                     : (int)states;
+    lazy->pool_budget = cache_bytes / 2 / sizeof(int);
+    lazy->next = xrealloc(NULL, (size_t)lazy->max_states * lazy->num_classes * sizeof(int32_t));
+    lazy->accept = xrealloc(NULL, (size_t)lazy->max_states);
+    lazy->dead = -1;
+
+    subsetsInit(&core->sub, &core->re, lazy->max_states);
+    core->saved = xrealloc(NULL, (size_t)core->re.num_nfa * sizeof(int));
+    startSet(&core->sub);
+    core->num_start = core->sub.num_members;
+    core->start_members = xrealloc(NULL, ((size_t)core->num_start + 1) * sizeof(int));
+    memcpy(core->start_members, core->sub.members, (size_t)core->num_start * sizeof(int));
+    lazy->start = lazyIntern(lazy);
+    return 0;
+}
+
+void regexLazyFree(RegexLazy *lazy) {
+    struct RegexLazyCore *core = lazy->core;
+    if (core) {
+        subsetsFree(&core->sub);
+        freeRegex(&core->re);
+        free(core->start_members);
+        free(core->saved);
+        free(core);
+    }
+    free(lazy->next);
+    free(lazy->accept);
+    memset(lazy, 0, sizeof(*lazy));
+}
+
+size_t regexLazyRun(RegexLazy *lazy, int *state, const char *input, size_t len) {
+    const unsigned char *p = (const unsigned char *)input;
+    const int32_t *next = lazy->next;
+    const int k = lazy->num_classes;
+    int s = *state;
+    size_t i = 0;
+
+    while (i < len && s != lazy->dead) {
+        int c = lazy->class_of[p[i++]];
+        int t = next[(size_t)s * k + c];
+        s = t >= 0 ? t : lazyTransition(lazy, &s, c);
+    }
+    *state = s;
+    return i;
+}
@@ -0,0 +1,131 @@
+#ifndef DFA_REGEX_H
+#define DFA_REGEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dfa_engine.h"
+
+/*
+ * Regular-expression front end for the DFA engine
+ *
+ * A pattern describes the whole input (there are no anchors; write .*
+ * around it to search inside a string):
+ *
+ *     0*10*          exactly one '1' among '0's
+ *     (0|1)*11       binary strings ending in "11"
+ *     [a-z_]\w*      an identifier
+ *
+ * Supported syntax: literals, '.' (any byte), classes [abc] [a-z] [^...],
+ * grouping ( ), alternation |, repetition * + ? {n} {n,} {n,m}, and the
+ * escapes \n \t \r \xHH \d \D \s \S \w \W; a backslash before any other
+ * character makes it literal. The pattern is parsed into a Thompson NFA,
+ * which subset construction turns into a dense table over byte classes.
+ */
+
+#define REGEX_MAX_REPEAT 255      // largest bound in {n,m}
+#define REGEX_MAX_NFA_STATES 100000
+
+/*
+ * Compile a pattern to a DFA table
+ *
+ * The table comes straight from subset construction; run it through
+ * dfaMinimize() for the smallest machine. States are numbered in the order
+ * they were discovered, the start state is 0.
+ *
+ * @param pattern - The pattern, NUL-terminated
+ * @param dfa - Receives the table
+ * @param error - Receives the reason on failure, "position N: ..." for
+ *                syntax errors
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 if the pattern is invalid, -2 if it needs more
+ *         than DFA_MAX_STATES states (see RegexLazy)
+ */
+int regexCompile(const char *pattern, Dfa *dfa, char *error, size_t error_size);
+
+#define REGEX_LAZY_DEFAULT_CACHE (8u << 20) // bytes
+#define REGEX_LAZY_MIN_STATES 16
+
+/*
+ * Lazily built DFA for patterns whose full subset construction blows up
+ *
+ * DFA states are created the first time a run reaches them and kept in a
+ * cache of bounded size; when it fills up the cache is flushed and
+ * rebuilt from the states the run visits next. Memory stays within the
+ * budget whatever the pattern, and a run through cached states costs one
+ * class lookup and one table lookup per byte, as with a precompiled table.
+ *
+ * State ids are cache slots. A flush renumbers them, so a caller must only
+ * keep the state returned by the latest regexLazyRun() and use start as
+ * it is now, not as it was when saved.
+ *
+ * @param num_classes - Number of byte classes, one table column each
+ * @param class_of - Byte class of each input byte
+ * @param next - next[state * num_classes + class], -1 until built
+ * @param accept - Nonzero for accepting states
+ * @param start - Current id of the start state
+ * @param dead - Current id of the state that matches nothing, -1 if not built
+ * @param max_states - Cache capacity in states
+ * @param pool_budget - Cache capacity for the NFA state sets, in entries
+ * @param flushes - Number of times the cache was flushed
+ * @param built - Number of transitions computed
+ * @param core - Pattern and subset bookkeeping, private to dfa_regex.c
+ */
+typedef struct {
+    int num_classes;
+    uint8_t class_of[DFA_SYMBOLS];
+    int32_t *next;
+    uint8_t *accept;
+    int start;
+    int dead;
+    int max_states;
+    size_t pool_budget;
+    size_t flushes;
+    size_t built;
+    struct RegexLazyCore *core;
+} RegexLazy;
+
+/*
+ * Parse a pattern for lazy matching
+ *
+ * @param lazy - The lazy DFA to initialise
+ * @param pattern - The pattern, NUL-terminated
+ * @param cache_bytes - Memory budget for the state cache
+ * @param error - Receives "position N: reason" on failure
+ * @param error_size - Size of the error buffer
+ * @return 0 on success, -1 if the pattern is invalid
+ */
+int regexLazyInit(RegexLazy *lazy, const char *pattern, size_t cache_bytes, char *error, size_t error_size);
+
+/*
+ * Free a lazy DFA and its cache
+ *
+ * @param lazy - The lazy DFA to free
+ */
+void regexLazyFree(RegexLazy *lazy);
+
+/*
+ * Run over a block of input, building states as they are reached and
+ * stopping early in the dead state
+ *
+ * @param lazy - The lazy DFA
+ * @param state - The state to start from, receives the final state
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless the dead state was entered
+ */
+size_t regexLazyRun(RegexLazy *lazy, int *state, const char *input, size_t len);
+
+/*
+ * Check whether a state of the lazy DFA is accepting
+ *
+ * @param lazy - The lazy DFA
+ * @param state - A state returned by the latest run
+ * @return true if the state is accepting
+ */
+static inline bool regexLazyIsAccepting(const RegexLazy *lazy, int state) {
+    return lazy->accept[state] != 0;
+}
+
+#endif
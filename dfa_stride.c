@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfa_stride.h"
+
+#define SINK_CHECK_LOOKUPS 8 // k-symbol lookups between sink checks
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define STRIDE_SWAR 1 // pack 8 bytes with one 64-bit load
+#endif
+
+#define LOW7 0x7F7F7F7F7F7F7F7Full
+
+/*
+ * High bit of every byte of x that is not zero
+ */
+static inline uint64_t nonZeroBytes(uint64_t x) {
+    return (((x & LOW7) + LOW7) | x) & ~LOW7;
+}
+
+/*
+ * Pack k bytes into a k-bit index, first byte in the high bit
+ *
+ * @return false if a byte is outside the alphabet
+ */
+static inline bool pack(const DfaStride *table, const unsigned char *q, int k, unsigned *index) {
+#ifdef STRIDE_SWAR
+    if (k == 8) {
+        uint64_t v;
+        memcpy(&v, q, sizeof(v));
+        uint64_t not_zero = nonZeroBytes(v ^ table->zeros);
+        uint64_t not_one = nonZeroBytes(v ^ table->ones);
+        if (not_zero & not_one)
+            return false;
+        // one bit per byte, gathered into the top byte by the multiply
+        *index = (unsigned)((((~not_one & ~LOW7) >> 7) * 0x8040201008040201ull) >> 56);
+        return true;
+    }
+#endif
+    unsigned bits = 0, outside = 0;
+    for (int i = 0; i < k; i++) {
+        unsigned bit = table->symbol[q[i]];
+        outside |= bit;
+        bits = (bits << 1) | (bit & 1);
+    }
+    *index = bits;
+    return outside <= 1;
+}
+
+bool dfaStrideAlphabet(const Dfa *dfa, unsigned char *zero, unsigned char *one) {
+    int class_of[DFA_SYMBOLS];
+    int size[DFA_SYMBOLS] = { 0 };
+    int k = dfaByteClasses(dfa, class_of, NULL);
+    int largest = 0;
+
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        size[class_of[c]]++;
+    }
+    for (int j = 1; j < k; j++) {
+        if (size[j] > size[largest])
+            largest = j;
+    }
+    if (size[largest] != DFA_SYMBOLS - 2)
+        return false;
+
+    int found = 0;
+    for (int c = 0; c < DFA_SYMBOLS; c++) {
+        if (class_of[c] != largest)
+            *(found++ ? one : zero) = (unsigned char)c;
+    }
+    return true;
+}
+
+void dfaStrideInit(DfaStride *table, const Dfa *base, unsigned char zero, unsigned char one, int stride) {
+    size_t width = (size_t)1 << stride;
+
+    table->base = base;
+    table->stride = stride;
+    table->next = malloc((size_t)base->num_states * width * sizeof(DfaState));
+    if (!table->next) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    memset(table->symbol, 0xFF, sizeof(table->symbol));
+    table->symbol[zero] = 0;
+    table->symbol[one] = 1;
+    table->zeros = 0x0101010101010101ull * zero;
+    table->ones = 0x0101010101010101ull * one;
+
+    for (int s = 0; s < base->num_states; s++) {
+        for (size_t index = 0; index < width; index++) {
+            DfaState t = (DfaState)s;
+            for (int bit = stride - 1; bit >= 0; bit--) {
+                t = dfaStep(base, t, (index >> bit) & 1 ? one : zero);
+            }
+            table->next[((size_t)s << stride) | index] = t;
+        }
+    }
+}
+
+void dfaStrideFree(DfaStride *table) {
+    free(table->next);
+    table->next = NULL;
+}
+
+/*
+ * The run loop, inlined once per stride so k is a constant
+ */
+static inline size_t strideRun(const DfaStride *table, DfaState *state, const unsigned char *p, size_t len, int k) {
+    const Dfa *base = table->base;
+    const DfaState *next = table->next;
+    const size_t group = (size_t)k * SINK_CHECK_LOOKUPS;
+    DfaState s = *state;
+    size_t done = 0;
+
+    while (len - done >= group && !dfaIsSink(base, s)) {
+        DfaState start = s;
+        for (int lookup = 0; lookup < SINK_CHECK_LOOKUPS; lookup++) {
+            const unsigned char *q = p + done + (size_t)lookup * k;
+            unsigned index;
+            if (pack(table, q, k, &index))
+                s = next[((size_t)s << k) | index];
+            else
+                s = dfaRun(base, s, (const char *)q, (size_t)k);
+        }
+        if (dfaIsSink(base, s)) {
+            // Walk the group again one byte at a time to find where the sink began
+            s = start;
+            while (!dfaIsSink(base, s)) {
+                s = dfaStep(base, s, p[done++]);
+            }
+            *state = s;
+            return done;
+        }
+        done += group;
+    }
+
+    *state = s;
+    return done + dfaRunUntilSink(base, state, (const char *)p + done, len - done);
+}
+
+size_t dfaStrideRun(const DfaStride *table, DfaState *state, const char *input, size_t len) {
+    const unsigned char *p = (const unsigned char *)input;
+
+    switch (table->stride) {
+    case 8:
+        return strideRun(table, state, p, len, 8);
+    case 4:
+        return strideRun(table, state, p, len, 4);
+    case 2:
+        return strideRun(table, state, p, len, 2);
+    default:
+        return strideRun(table, state, p, len, table->stride);
+    }
+}
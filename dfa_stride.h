@@ -0,0 +1,77 @@
+#ifndef DFA_STRIDE_H
+#define DFA_STRIDE_H
+
+#include "dfa_engine.h"
+
+#define DFA_STRIDE_MAX 8 // symbols per lookup, 2^8 entries per state
+
+/*
+ * Multi-stride transition table for a DFA over a two-symbol alphabet
+ *
+ * Each lookup advances k input symbols: the k bytes are packed into a
+ * k-bit index (first byte in the high bit) and next[state << k | index]
+ * gives the state k steps later. Packing does not depend on the state, so
+ * the chain of dependent loads is k times shorter than in dfaRun(). Blocks
+ * holding a byte outside the alphabet, and the tail, go through the base
+ * table one byte at a time.
+ *
+ * @param base - The DFA the table was built from, not owned
+ * @param stride - Symbols per lookup, k
+ * @param symbol - Alphabet bit of each byte (0 or 1), 0xFF outside it
+ * @param zeros - The zero symbol in every byte, for packing 8 bytes at once
+ * @param ones - The one symbol in every byte
+ * @param next - k-step table, num_states << k entries
+ */
+typedef struct {
+    const Dfa *base;
+    int stride;
+    uint8_t symbol[DFA_SYMBOLS];
+    uint64_t zeros;
+    uint64_t ones;
+    DfaState *next;
+} DfaStride;
+
+/*
+ * Find the two symbols of a machine over a binary alphabet
+ *
+ * Looks for exactly two bytes whose columns differ from those of the
+ * largest byte class (the bytes outside the alphabet), so it works on
+ * tables with no description behind them, such as compiled patterns.
+ *
+ * @param dfa - The DFA
+ * @param zero - Receives the lower of the two bytes
+ * @param one - Receives the higher one
+ * @return true if the machine has such a pair
+ */
+bool dfaStrideAlphabet(const Dfa *dfa, unsigned char *zero, unsigned char *one);
+
+/*
+ * Build the k-step table for a two-symbol alphabet
+ *
+ * @param table - The table to initialise
+ * @param base - The DFA, which must outlive the table
+ * @param zero - The alphabet symbol packed as bit 0
+ * @param one - The alphabet symbol packed as bit 1
+ * @param stride - Symbols per lookup: 2, 4 or 8
+ */
+void dfaStrideInit(DfaStride *table, const Dfa *base, unsigned char zero, unsigned char one, int stride);
+
+/*
+ * Free a k-step table
+ *
+ * @param table - The table to free
+ */
+void dfaStrideFree(DfaStride *table);
+
+/*
+ * Run over a block of input k symbols at a time, stopping early at a sink
+ *
+ * @param table - The k-step table
+ * @param state - The state to start from, receives the final state
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t dfaStrideRun(const DfaStride *table, DfaState *state, const char *input, size_t len);
+
+#endif
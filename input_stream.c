@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "input_stream.h"
+
+#define MAX_CARRY 2 // longest possible final newline, "\r\n"
+
+int streamOpen(InputStream *stream, const char *path) {
+    if (path == NULL || strcmp(path, "-") == 0) {
+        stream->file = stdin;
+        stream->owned = false;
+    } else {
+        stream->file = fopen(path, "rb");
+        if (!stream->file)
+            return -1;
+        stream->owned = true;
+    }
+
+    stream->buffer = malloc(STREAM_CHUNK_SIZE + MAX_CARRY);
+    if (!stream->buffer) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    stream->carry_len = 0;
+    stream->total = 0;
+    return 0;
+}
+
+size_t streamRead(InputStream *stream, const char **chunk) {
+    char *buf = stream->buffer;
+
+    *chunk = buf;
+    for (;;) {
+        memcpy(buf, stream->carry, (size_t)stream->carry_len);
+        size_t n = fread(buf + stream->carry_len, 1, STREAM_CHUNK_SIZE, stream->file);
+        size_t have = (size_t)stream->carry_len + n;
+
+        if (n == 0) {
+            // End of input: a held-back "\n" or "\r\n" was the final newline
+            bool newline = have > 0 && buf[have - 1] == '\n';
+            size_t len = newline ? 0 : have;
+            stream->carry_len = 0;
+            stream->total += len;
+            return len;
+        }
+
+        // Hold back a trailing newline until we know whether more data follows
+        int carry = 0;
+        if (have >= 2 && buf[have - 2] == '\r' && buf[have - 1] == '\n')
+            carry = 2;
+        else if (buf[have - 1] == '\n' || buf[have - 1] == '\r')
+            carry = 1;
+
+        memcpy(stream->carry, buf + have - carry, (size_t)carry);
+        stream->carry_len = carry;
+        if (have > (size_t)carry) {
+            stream->total += have - (size_t)carry;
+            return have - (size_t)carry;
+        }
+        // Only newline bytes so far, keep reading
+    }
+}
+
+void streamClose(InputStream *stream) {
+    if (stream->owned && stream->file)
+        fclose(stream->file);
+    free(stream->buffer);
+    stream->buffer = NULL;
+    stream->file = NULL;
+}
+
+int lineReaderOpen(LineReader *reader, const char *path) {
+    if (path == NULL || strcmp(path, "-") == 0) {
+        reader->file = stdin;
+        reader->owned = false;
+    } else {
+        reader->file = fopen(path, "rb");
+        if (!reader->file)
+            return -1;
+        reader->owned = true;
+    }
+
+    reader->capacity = STREAM_CHUNK_SIZE;
+    reader->buffer = malloc(reader->capacity);
+    if (!reader->buffer) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    reader->start = 0;
+    reader->end = 0;
+    reader->eof = false;
+    return 0;
+}
+
+bool readLine(LineReader *reader, const char **line, size_t *len) {
+    size_t scanned = reader->start;
+
+    for (;;) {
+        char *nl = memchr(reader->buffer + scanned, '\n', reader->end - scanned);
+        if (nl || (reader->eof && reader->start < reader->end)) {
+            char *first = reader->buffer + reader->start;
+            char *last = nl ? nl : reader->buffer + reader->end;
+            reader->start = nl ? (size_t)(nl - reader->buffer) + 1 : reader->end;
+            if (nl && last > first && last[-1] == '\r')
+                last--;
+            *line = first;
+            *len = (size_t)(last - first);
+            return true;
+        }
+        if (reader->eof)
+            return false;
+
+        // No full line buffered: slide the partial line down, grow if needed, refill
+        size_t kept = reader->end - reader->start;
+        memmove(reader->buffer, reader->buffer + reader->start, kept);
+        reader->start = 0;
+        reader->end = kept;
+        scanned = kept;
+        if (kept == reader->capacity) {
+            char *grown = realloc(reader->buffer, reader->capacity * 2);
+            if (!grown) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                exit(1);
+            }
+            reader->buffer = grown;
+            reader->capacity *= 2;
+        }
+        size_t n = fread(reader->buffer + kept, 1, reader->capacity - kept, reader->file);
+        reader->end += n;
+        if (n == 0)
+            reader->eof = true;
+    }
+}
+
+void lineReaderClose(LineReader *reader) {
+    if (reader->owned && reader->file)
+        fclose(reader->file);
+    free(reader->buffer);
+    reader->buffer = NULL;
+    reader->file = NULL;
+}
+
+int readWord(FILE *file, char **word, size_t *capacity) {
+    size_t len = 0;
+    int c;
+
+    while ((c = getc(file)) != EOF && isspace(c)) {
+    }
+    for (; c != EOF && !isspace(c); c = getc(file)) {
+        if (len + 1 >= *capacity) {
+            size_t grown = *capacity ? *capacity * 2 : 128;
+            char *buffer = realloc(*word, grown);
+            if (!buffer) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                exit(1);
+            }
+            *word = buffer;
+            *capacity = grown;
+        }
+        (*word)[len++] = (char)c;
+    }
+    if (len == 0)
+        return 0;
+    ungetc(c, file);
+    (*word)[len] = '\0';
+    return 1;
+}
+
+#ifndef _WIN32
+
+/*
+ * Leave one trailing "\n" or "\r\n" out of the input string
+ */
+static size_t trimNewline(const char *data, size_t len) {
+    if (len > 0 && data[len - 1] == '\n') {
+        len--;
+        if (len > 0 && data[len - 1] == '\r')
+            len--;
+    }
+    return len;
+}
+
+int mapInput(MappedInput *input, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        // a pipe or terminal has no size to map and would read as empty
+        close(fd);
+        errno = ENODEV;
+        return -1;
+    }
+
+    input->copy = NULL;
+    input->map_len = (size_t)st.st_size;
+    if (input->map_len == 0) {
+        // mmap() rejects empty ranges, an empty file is just the empty string
+        input->data = "";
+        input->len = 0;
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, input->map_len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (map == MAP_FAILED)
+        return -1;
+    madvise(map, input->map_len, MADV_SEQUENTIAL);
+
+    input->data = map;
+    input->len = trimNewline(input->data, input->map_len);
+    return 0;
+}
+
+void unmapInput(MappedInput *input) {
+    if (input->map_len > 0)
+        munmap((void *)input->data, input->map_len);
+    input->data = NULL;
+    input->len = 0;
+    input->map_len = 0;
+}
+
+#else
+
+int mapInput(MappedInput *input, const char *path) {
+    InputStream stream;
+    if (streamOpen(&stream, path) != 0)
+        return -1;
+
+    size_t capacity = STREAM_CHUNK_SIZE;
+    size_t size = 0;
+    char *copy = malloc(capacity);
+    const char *chunk;
+    size_t len;
+    while (copy && (len = streamRead(&stream, &chunk)) > 0) {
+        if (size + len > capacity) {
+            capacity = (size + len) * 2;
+            char *grown = realloc(copy, capacity);
+            if (!grown) {
+                free(copy);
+                copy = NULL;
+                break;
+            }
+            copy = grown;
+        }
+        memcpy(copy + size, chunk, len);
+        size += len;
+    }
+    streamClose(&stream);
+    if (!copy) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    input->copy = copy;
+    input->data = copy;
+    input->len = size; // streamRead() already dropped the trailing newline
+    input->map_len = 0;
+    return 0;
+}
+
+void unmapInput(MappedInput *input) {
+    free(input->copy);
+    input->copy = NULL;
+    input->data = NULL;
+    input->len = 0;
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef INPUT_STREAM_H
+#define INPUT_STREAM_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define STREAM_CHUNK_SIZE (1u << 20) // bytes read per fread()
+
+/*
+ * Chunked reader over a file or stdin
+ *
+ * The whole stream is one input string. A single trailing newline ("\n"
+ * or "\r\n") is treated as the end of the string, not part of it, so
+ * `echo 0110 | ./dfa --stream` works as expected.
+ *
+ * @param file - The file being read
+ * @param owned - true if streamClose() should fclose() the file
+ * @param buffer - Chunk buffer, STREAM_CHUNK_SIZE plus room for the carry
+ * @param carry - Trailing newline bytes held back from the last chunk
+ * @param carry_len - Number of bytes in carry
+ * @param total - Bytes handed out so far
+ */
+typedef struct {
+    FILE *file;
+    bool owned;
+    char *buffer;
+    char carry[2];
+    int carry_len;
+    size_t total;
+} InputStream;
+
+/*
+ * Open a stream
+ *
+ * @param stream - The stream to initialise
+ * @param path - File to read, NULL or "-" for stdin
+ * @return 0 on success, -1 if the file cannot be opened (errno is set)
+ */
+int streamOpen(InputStream *stream, const char *path);
+
+/*
+ * Read the next chunk of the input string
+ *
+ * @param stream - The stream
+ * @param chunk - Set to the start of the chunk, valid until the next call
+ * @return Length of the chunk, 0 at the end of the input
+ */
+size_t streamRead(InputStream *stream, const char **chunk);
+
+/*
+ * Close a stream and free its buffer
+ *
+ * @param stream - The stream
+ */
+void streamClose(InputStream *stream);
+
+/*
+ * Newline-delimited reader for batch mode
+ *
+ * Lines may be any length; the buffer grows to hold the longest one.
+ * The "\n" and an optional "\r" before it are not part of the line.
+ *
+ * @param file - The file being read
+ * @param owned - true if lineReaderClose() should fclose() the file
+ * @param buffer - Read buffer
+ * @param capacity - Size of buffer
+ * @param start - First unconsumed byte in buffer
+ * @param end - One past the last byte read into buffer
+ * @param eof - The file has been read to the end
+ */
+typedef struct {
+    FILE *file;
+    bool owned;
+    char *buffer;
+    size_t capacity;
+    size_t start;
+    size_t end;
+    bool eof;
+} LineReader;
+
+/*
+ * Open a line reader
+ *
+ * @param reader - The reader to initialise
+ * @param path - File to read, NULL or "-" for stdin
+ * @return 0 on success, -1 if the file cannot be opened (errno is set)
+ */
+int lineReaderOpen(LineReader *reader, const char *path);
+
+/*
+ * Read the next line
+ *
+ * @param reader - The reader
+ * @param line - Set to the start of the line, valid until the next call
+ * @param len - Set to the length of the line
+ * @return true if a line was read, false at the end of the input
+ */
+bool readLine(LineReader *reader, const char **line, size_t *len);
+
+/*
+ * Close a line reader and free its buffer
+ *
+ * @param reader - The reader
+ */
+void lineReaderClose(LineReader *reader);
+
+/*
+ * Read one whitespace-delimited word, of any length
+ *
+ * For the interactive menus; the whitespace after the word is left unread.
+ *
+ * @param file - The file to read from
+ * @param word - Buffer holding the word, grown as needed; NULL to start
+ * @param capacity - Size of the buffer, 0 to start
+ * @return 1 if a word was read, 0 at the end of the input
+ */
+int readWord(FILE *file, char **word, size_t *capacity);
+
+/*
+ * Read-only view of a whole input file
+ *
+ * On POSIX systems the file is mmap()ed and advised for sequential access,
+ * so the engines read straight from the page cache and processes checking
+ * the same file share its pages. Elsewhere the file is read into memory.
+ * As with streams, one trailing newline is left out of len.
+ *
+ * @param data - First byte of the input
+ * @param len - Length of the input string
+ * @param map_len - Length of the mapping, 0 if nothing is mapped
+ * @param copy - Heap copy used when mmap() is unavailable
+ */
+typedef struct {
+    const char *data;
+    size_t len;
+    size_t map_len;
+    char *copy;
+} MappedInput;
+
+/*
+ * Map a file for reading
+ *
+ * @param input - The mapping to initialise
+ * @param path - File to map
+ * @return 0 on success, -1 on failure (errno is set, to ENODEV if path is
+ *         not a regular file; read pipes and devices with streamOpen())
+ */
+int mapInput(MappedInput *input, const char *path);
+
+/*
+ * Release a mapping
+ *
+ * @param input - The mapping
+ */
+void unmapInput(MappedInput *input);
+
+#endif
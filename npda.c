@@ -2,6 +2,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <errno.h>
+
+#include "automaton_spec.h"
+#include "input_stream.h"
+#include "npda_frontier.h"
+#include "stack_forest.h"
 
 #define PINK_BG "\033[48;5;218m"
 #define RESET   "\033[0m"
@@ -11,152 +18,132 @@
 #define BLUE    "\033[34m"
 #define MAGENTA "\033[35m"
 #define WHITE   "\033[37m"
-#define MAX_SIZE 1000
 #define MAX_STACK_SIZE 100
-#define MAX_CONFIGURATIONS 100 
-#define MAX_INPUT_SIZE 100
-
-typedef enum {
-    S0, // pushing a's
-    S1, // popping a's with b's
-    S2, // accept after extra b
-    //S3 // reject  
-} State;
-
-/*
- * Define the stack of the PDA
- * 
- * @param items - The items in the stack
- * @param top - The top of the stack
- */
-typedef struct {
-    char *items;
-    int top;
-} Stack;
 
+// Built-in description of the machine, same format as specs/palindrome.npda
+static const char BUILTIN_SPEC[] =
+    "type npda\n"
+    "states S0 S1\n"
+    "alphabet 0 1\n"
+    "stack 0 1\n"
+    "start S0\n"
+    "accept S1\n"
+    "accept-stack empty\n"
+    "S0 0 * -> S0 push 0\n"
+    "S0 1 * -> S0 push 1\n"
+    "S0 0 * -> S1\n"
+    "S0 1 * -> S1\n"
+    "S0 - * -> S1\n"
+    "S1 0 0 -> S1 pop\n"
+    "S1 1 1 -> S1 pop\n";
+
+// The machine being run, the built-in one or the one loaded with --spec
+static AutomatonSpec desc;
+static bool in_alphabet[256];
+static char alphabet_list[512];      // "0, 1" for messages
+static int moves_from[SPEC_MAX_STATES + 1]; // first entry of each state in moves
+static int *moves;                   // transition indices grouped by source state
 
 // --- Configuration (State + Stack + Position) ---
-// This struct represents one possible path of the NPDA.
-typedef struct {
-    State state;                // The state (q0 or q1)
-    Stack stack;            // The stack for this path
-    int input_pos;          // Position in the input string
-} Configuration;
+// One possible path of the NPDA, kept in an NpdaFrontier generation.
+typedef NpdaConfig Configuration;
 
 
 /*
- * Initialize the stack of the PDA
- * 
- * @param stack - The stack of the PDA
+ * Validate input string contains only symbols of the alphabet
  */
-void initStack(Stack *stack) {
-    stack->items = malloc(MAX_SIZE * sizeof(char));
-    if (!stack->items) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(1);
+int validateInput(const char* str) {
+    for (size_t i = 0; str[i] != '\0'; i++) {
+        if (!in_alphabet[(unsigned char)str[i]]) {
+            return 0;
+        }
     }
-    stack->top = -1;
-}
-
-
-/*
- * Push a symbol onto the stack
- * 
- * @param stack - The stack of the PDA
- * @param symbol - The symbol to push
- */
-void push(Stack *stack, char symbol) {
-    stack->items[++(stack->top)] = symbol;
+    return 1;
 }
 
 /*
- * Pop a symbol from the stack
- * 
- * @param stack - The stack of the PDA
- * @return The symbol popped from the stack
+ * Validate a buffer of known length contains only symbols of the alphabet
  */
-char pop(Stack *stack) {
-    if (stack->top < 0) {
-        fprintf(stderr, "Stack underflow.\n");
-        exit(1);
+int validateInputLength(const char* str, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (!in_alphabet[(unsigned char)str[i]]) {
+            return 0;
+        }
     }
-    return stack->items[(stack->top)--];
-}
-
-/*
- * Peek at the top of the stack
- * 
- * @param stack - The stack of the PDA
- * @return The symbol at the top of the stack
- */
-char peek(Stack *stack) {
-    if (stack->top < 0)
-        return '$';  // treat empty as bottom marker
-    return stack->items[stack->top];
+    return 1;
 }
 
 /*
- * Check if the stack is empty
- * 
- * @param stack - The stack of the PDA
- * @return 1 if the stack is empty, 0 otherwise
+ * Load an NPDA description and index its transitions by source state
+ *
+ * A deterministic PDA description runs unchanged, as an NPDA that never
+ * has more than one move to choose from.
+ *
+ * @param path - Description file, NULL for the built-in machine
+ * @return 0 on success, -1 after printing the reason
  */
-int isEmpty(Stack *stack) {
-    return stack->top == -1;
-}
+int loadSpec(const char *path) {
+    char error[512];
+    int result = path ? specLoad(&desc, path, error, sizeof(error))
+                      : specParse(&desc, BUILTIN_SPEC, error, sizeof(error));
+    if (result != 0) {
+        fprintf(stderr, "Invalid automaton description: %s\n", error);
+        return -1;
+    }
+    if (desc.type == SPEC_DFA) {
+        fprintf(stderr, "Invalid automaton description: %s: not a PDA or NPDA description\n", path ? path : "built-in");
+        specFree(&desc);
+        return -1;
+    }
 
+    int len = 0;
+    for (int a = 0; a < desc.alphabet_size; a++) {
+        in_alphabet[(unsigned char)desc.alphabet[a]] = true;
+        len += snprintf(alphabet_list + len, sizeof(alphabet_list) - (size_t)len, a ? ", %c" : "%c", desc.alphabet[a]);
+    }
 
-/*
- * Free the stack of the PDA
- * 
- * @param stack - The stack of the PDA
- */
-void freeStack(Stack *stack) {
-    if (stack->items) {
-        free(stack->items);
-        stack->items = NULL; // Prevent double-freeing
+    moves = malloc(((size_t)desc.num_transitions + 1) * sizeof(int));
+    if (!moves) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    // Counting sort: moves_from[s + 1] counts, then prefix sums, then fill
+    memset(moves_from, 0, sizeof(moves_from));
+    for (int i = 0; i < desc.num_transitions; i++) {
+        moves_from[desc.transitions[i].from + 1]++;
     }
+    for (int s = 0; s < desc.num_states; s++) {
+        moves_from[s + 1] += moves_from[s];
+    }
+    int fill[SPEC_MAX_STATES];
+    memcpy(fill, moves_from, sizeof(fill));
+    for (int i = 0; i < desc.num_transitions; i++) {
+        moves[fill[desc.transitions[i].from]++] = i;
+    }
+    return 0;
 }
 
 /*
- * Function to duplicate a stack for a new simulation path
- * @param src - Source stack to copy from
- * @param dest - Destination stack to copy to
+ * Free the machine loaded by loadSpec()
  */
-void copyStack(const Stack* src, Stack* dest) {
-    initStack(dest);
-    for (int i = 0; i <= src->top; i++) {
-        dest->items[i] = src->items[i];
-    }
-    dest->top = src->top;
+void unloadSpec() {
+    specFree(&desc);
+    free(moves);
+    moves = NULL;
 }
-
-
 /*
- * Validate input string contains only 0s and 1s
+ * Print the symbols of a stack, bottom first
  */
-int validateInput(const char* str) {
-    for (int i = 0; str[i] != '\0'; i++) {
-        if (str[i] != '0' && str[i] != '1') {
-            return 0;
-        }
-    }
-    return 1;
+static void printSymbols(const StackForest *forest, StackNode top) {
+    if (top == FOREST_EMPTY)
+        return;
+    printSymbols(forest, forestPop(forest, top));
+    printf("%c", forestPeek(forest, top));
 }
 
-const char* stateToString(State s) {
-    switch (s) {
-        case S0: return "S0";
-        case S1: return "S1";
-        case S2: return "S2";
-    }
-    return "??";
-}
-void printStack(const Stack* stack) {
+void printStack(const StackForest *forest, StackNode top) {
     printf("[");
-    for (int i = 0; i <= stack->top; i++) {
-        printf("%c", stack->items[i]);
-    }
+    printSymbols(forest, top);
     printf("]");
 }
 
@@ -196,192 +183,126 @@ void printWelcomeMessage() {
  */
 void printTransitionTable() {
     printf("\n" YELLOW "NPDA Transition Table for Palindromes:" RESET "\n");
-    printf("┌───────┬────────┬───────────┬──────────────────┬────────────┐\n");
-    printf("│ State │ Input  │ Stack Top │      Action      │ Next State │\n");
-    printf("├───────┼────────┼───────────┼──────────────────┼────────────┤\n");
-    printf("│  S0   │   1    │     1     │   Push 1,1       │     S0     │\n");
-    printf("│  S0   │   1    │     0     │   Push 1,0       │     S0     │\n");
-    printf("│  S0   │   0    │     1     │   Push 0,1       │     S0     │\n");
-    printf("│  S0   │   0    │     0     │   Push 0,0       │     S0     │\n");
-    printf("│  S0   │   0    │     @     │   Push 0         │     S0     │\n");
-    printf("│  S0   │   1    │     @     │   Push 1         │     S0     │\n");
-    printf("│  S0   │   1    │     1     │   Pop 1          │     S1     │\n");
-    printf("│  S0   │   0    │     0     │   Pop 0          │     S1     │\n");
-    printf("│  S0   │   ε    │     1     │   Pop 1          │     S1     │\n");
-    printf("│  S0   │   ε    │     0     │   Pop 0          │     S1     │\n");
-    printf("│  S1   │   0    │     0     │   Pop 0          │     S1     │\n");
-    printf("│  S1   │   1    │     1     │   Pop 1          │     S1     │\n");
-    printf("│  S1   │   ε    │     Z     │   No change      │    *S2     │\n");
-    printf("└───────┴────────┴───────────┴──────────────────┴────────────┘\n");
-    printf("@ = empty stack, Z = stack bottom, S2 = accept state\n\n");
+    specPrintTable(&desc);
+}
+
+#define TRACE(...) do { if (trace) printf(__VA_ARGS__); } while (0)
+
+/*
+ * Add a configuration to a generation
+ *
+ * @param frontier - The generation
+ * @param conf - The configuration
+ * @param forest - The run's stacks, for the trace
+ * @param trace - Print the configuration and whether it was merged
+ */
+static void addConfig(NpdaFrontier *frontier, Configuration conf, const StackForest *forest, bool trace) {
+    *frontierAdd(frontier) = conf;
+    TRACE("Creating new config (%s, pos %d, stack ", desc.state_names[conf.state], conf.input_pos);
+    if (trace) printStack(forest, conf.stack);
+    TRACE(")\n");
+    if (!frontierCommit(frontier))
+        TRACE("       (already in the generation, merged)\n");
+}
+
+/*
+ * Whether a configuration that has read the whole input accepts
+ *
+ * @param conf - The configuration
+ * @param bottom - The stack holding only the bottom marker
+ */
+static bool isAccepting(const Configuration *conf, StackNode bottom) {
+    if (!desc.accepting[conf->state])
+        return false;
+    switch (desc.accept_stack) {
+    case ACCEPT_STACK_EMPTY:
+        return conf->stack == FOREST_EMPTY;
+    case ACCEPT_STACK_BOTTOM:
+        return conf->stack == bottom;
+    default:
+        return true;
+    }
 }
 
 /*
  * Non-deterministic transition function for the NPDA
+ *
+ * Generation k holds every configuration that has read k characters.
+ * Epsilon moves add to the generation being walked, so it is complete
+ * before the next character is read; the frontier drops any configuration
+ * reached twice, so epsilon cycles that leave the stack alone end. Cycles
+ * that push more than they pop are refused when the description is loaded.
  * 
  * @param input_string - The input string
  * @param len - Length of input string
+ * @param trace - Print every generation and configuration
  * @return 1 if accepted, 0 if rejected
- */int transition(const char* input_string, int len) {
-    Configuration current_configs[MAX_CONFIGURATIONS];
-    Configuration next_configs[MAX_CONFIGURATIONS];
-
-     int num_current_configs = 1;
-    int num_next_configs = 0;
-    int generation = 0;
-
-    initStack(&current_configs[0].stack);
-    current_configs[0].state = S0;
-    current_configs[0].input_pos =  0;
-    
-    if (num_current_configs < MAX_CONFIGURATIONS) {
-        current_configs[num_current_configs].state = S1;
-        copyStack(&current_configs[0].stack, &current_configs[num_current_configs].stack);
-        current_configs[num_current_configs].input_pos = 0;
-        num_current_configs++;
-    }
-
-    while (num_current_configs > 0) {
-        printf("\n--- Generation %d ---\n", generation++);
-        printf("Processing %d current configuration(s)...\n", num_current_configs );
-
-        num_next_configs = 0;
-        int accepted = 0;
-
-        for (int i = 0; i < num_current_configs; i++) {
-            Configuration conf = current_configs[i];
-            //debug
-            // printf("conf.state: %d\n", conf.state);
-            // printf("conf.input_pos: %d\n", conf.input_pos);
-            // printf("conf.stack.top: %d\n", conf.stack.top);
-            // printf("conf.stack.items: %s\n", conf.stack.items);
-            // printf("conf.stack.items[0]: %c\n", conf.stack.items[0]);
-            // printf("conf.stack.items[1]: %c\n", conf.stack.items[1]);
-            // printf("conf.stack.items[2]: %c\n", conf.stack.items[2]);
+ */
+int transition(const char* input_string, int len, bool trace) {
+    NpdaFrontier current, next;
+    StackForest forest;
+    frontierInit(&current);
+    frontierInit(&next);
+    forestInit(&forest);
+    int accepted = 0;
+
+    // The bottom marker, if the machine has one, is pushed before the run
+    StackNode bottom = desc.bottom >= 0 ? forestPush(&forest, FOREST_EMPTY, (char)desc.bottom) : FOREST_EMPTY;
+    TRACE("Start: ");
+    addConfig(&current, (Configuration){ desc.start, 0, bottom }, &forest, trace);
+
+    for (int pos = 0; current.count > 0 && !accepted; pos++) {
+        TRACE("\n--- Generation %d ---\n", pos);
+        TRACE("Processing configuration(s) that have read %d character(s)...\n", pos);
+
+        int c = pos < len ? (unsigned char)input_string[pos] : -1;
+        for (int i = 0; i < current.count; i++) {
+            Configuration conf = current.configs[i];
             // --- Print the configuration we are processing ---
-            printf("  [%d] Processing conf: State=%s, Pos=%d, Stack=", i, stateToString(conf.state), conf.input_pos);
-            printStack(&conf.stack);
-            printf("\n");
-
-            if (conf.input_pos == len) {
-                if (conf.state == S1 && isEmpty(&conf.stack)) {
-                    printf("    -> Path leads to ACCEPTANCE (End of input, S1, Empty Stack)\n");
-                    accepted = 1;
-                    //debug
-                    // printf("conf.state: %d\n", conf.state);
-                    // printf("conf.input_pos: %d\n", conf.input_pos);
-                    // printf("conf.stack.top: %d\n", conf.stack.top);
-                    // printf("conf.stack.items: %s\n", conf.stack.items);
-                } else {
-                    printf("    -> Path dies (End of input, non-accepting)\n");
-                    //debug
-                    // printf("conf.state: %d\n", conf.state);
-                    // printf("conf.input_pos: %d\n", conf.input_pos);
-                    // printf("conf.stack.top: %d\n", conf.stack.top);
-                    // printf("conf.stack.items: %s\n", conf.stack.items);
-                }
+            TRACE("  [%d] Processing conf: State=%s, Pos=%d, Stack=", i, desc.state_names[conf.state], conf.input_pos);
+            if (trace) printStack(&forest, conf.stack);
+            TRACE("\n");
+
+            if (pos == len && isAccepting(&conf, bottom)) {
+                TRACE("    -> Path leads to ACCEPTANCE (End of input, %s)\n", desc.state_names[conf.state]);
+                accepted = 1;
                 continue;
             }
-
-
-          char c = input_string[conf.input_pos];
-            printf("    (Input char: '%c')\n", c);
-
-            if (conf.state == S0) {
-
-                printf("    ->  Path 1 (Push): Creating new config (S0, pos+1, push '%c')\n", c);
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-                    next_configs[num_next_configs].state = S0;
-                    copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    push(&next_configs[num_next_configs].stack, c);
-                    next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                    num_next_configs++;
-                    //debug
-                    // printf("next_configs[num_next_configs].state: %d\n", next_configs[num_next_configs].state);
-                    // printf("next_configs[num_next_configs].input_pos: %d\n", next_configs[num_next_configs].input_pos);
-                    // printf("next_configs[num_next_configs].stack.top: %d\n", next_configs[num_next_configs].stack.top);
-                    // printf("next_configs[num_next_configs].stack.items: %s\n", next_configs[num_next_configs].stack.items);
-                    // printf("next_configs[num_next_configs].stack.items[0]: %c\n", next_configs[num_next_configs].stack.items[0]);
-                    // printf("next_configs[num_next_configs].stack.items[1]: %c\n", next_configs[num_next_configs].stack.items[1]);
-                }
-
-                // Odd Middle
-                printf("    -> Path 2 (Skip): Creating new config (S1, pos+1, stack unchanged)\n");
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-                    next_configs[num_next_configs].state = S1;
-                    copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                    num_next_configs++;
-                    //debug
-                    // printf("next_configs[num_next_configs].state: %d\n", next_configs[num_next_configs].state);
-                    // printf("next_configs[num_next_configs].input_pos: %d\n", next_configs[num_next_configs].input_pos);
-                    // printf("next_configs[num_next_configs].stack.top: %d\n", next_configs[num_next_configs].stack.top);
-                    // printf("next_configs[num_next_configs].stack.items: %s\n", next_configs[num_next_configs].stack.items);
-                    // printf("next_configs[num_next_configs].stack.items[0]: %c\n", next_configs[num_next_configs].stack.items[0]);
-                    // printf("next_configs[num_next_configs].stack.items[1]: %c\n", next_configs[num_next_configs].stack.items[1]);
-                }
-                
-                //even middle
-                printf("    -> Path 3 (Epsilon-Jump): Creating new config (S1, pos unchanged, stack unchanged)\n");
-                if (num_next_configs < MAX_CONFIGURATIONS) {
-
-                    next_configs[num_next_configs].state =  S1;
-                    copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                    next_configs[num_next_configs].input_pos = conf.input_pos;
-                    num_next_configs++;
-                    //debug 
-                    // printf("next_configs[num_next_configs].state: %d\n", next_configs[num_next_configs].state);
-                    // printf("next_configs[num_next_configs].input_pos: %d\n", next_configs[num_next_configs].input_pos);
-                    // printf("next_configs[num_next_configs].stack.top: %d\n", next_configs[num_next_configs].stack.top);
-                    // printf("next_configs[num_next_configs].stack.items: %s\n", next_configs[num_next_configs].stack.items);
-                    // printf("next_configs[num_next_configs].stack.items[0]: %c\n", next_configs[num_next_configs].stack.items[0]);
-                    // printf("next_configs[num_next_configs].stack.items[1]: %c\n", next_configs[num_next_configs].stack.items[1]);
-                }
-
-            } else if (conf.state == S1) {
-                if (!isEmpty(&conf.stack) && peek(&conf.stack) == c) {
-                    printf("    -> Path (Match & Pop): Input '%c' matches stack top. Creating new config (S1, pos+1, pop)\n",  c);
-                    if (num_next_configs < MAX_CONFIGURATIONS) {
-
-                        next_configs[num_next_configs].state = S1;
-                        copyStack(&conf.stack, &next_configs[num_next_configs].stack);
-                        pop(&next_configs[num_next_configs].stack);
-                        next_configs[num_next_configs].input_pos = conf.input_pos + 1;
-                        num_next_configs++;
-                        //debug
-                        // printf("next_configs[num_next_configs].state: %d\n", next_configs[num_next_configs].state);
-                        // printf("next_configs[num_next_configs].input_pos: %d\n", next_configs[num_next_configs].input_pos);
-                        // printf("next_configs[num_next_configs].stack.top: %d\n", next_configs[num_next_configs].stack.top);
-                        // printf("next_configs[num_next_configs].stack.items: %s\n", next_configs[num_next_configs].stack.items);
-                        // printf("next_configs[num_next_configs].stack.items[0]: %c\n", next_configs[num_next_configs].stack.items[0]);
-                        // printf("next_configs[num_next_configs].stack.items[1]: %c\n", next_configs[num_next_configs].stack.items[1]);
-                }
-                }
-                 else {
-                     printf("    -> Path dies (no match to pop)\n");
+            if (c >= 0)
+                TRACE("    (Input char: '%c')\n", c);
+
+            bool moved = false;
+            for (int k = moves_from[conf.state]; k < moves_from[conf.state + 1]; k++) {
+                const SpecTransition *t = &desc.transitions[moves[k]];
+                bool epsilon = t->input == SPEC_EPSILON;
+                if (t->top != SPEC_ANY && (conf.stack == FOREST_EMPTY || t->top != (unsigned char)forestPeek(&forest, conf.stack)))
+                    continue;
+                if (!epsilon && (c < 0 || (t->input == SPEC_ANY ? !in_alphabet[c] : t->input != c)))
+                    continue;
+
+                Configuration succ = { t->to, pos + !epsilon, t->pop ? forestPop(&forest, conf.stack) : conf.stack };
+                for (const char *p = t->push; *p; p++) {
+                    succ.stack = forestPush(&forest, succ.stack, *p);
                 }
+                TRACE("    -> Path (%s): ", epsilon ? "epsilon" : "read");
+                addConfig(epsilon ? &current : &next, succ, &forest, trace);
+                moved = true;
             }
+            if (!moved)
+                TRACE("    -> Path dies (%s)\n", pos == len ? "End of input, non-accepting" : "no move");
         }
 
-        //free current configs
-        for (int i = 0; i < num_current_configs; i++) {
-            free(current_configs[i].stack.items);
-        }
-        //free next configs
-        if (accepted) {
-            for (int i = 0; i < num_next_configs; i++) {
-                free(next_configs[i].stack.items);
-            }
-            return 1;
-        }
-        //copy next configs to current configs
-        num_current_configs = num_next_configs;
-        for (int i = 0; i < num_next_configs; i++) {
-            current_configs[i] = next_configs[i];
-        }
+        //the next generation becomes the current one
+        frontierClear(&current);
+        NpdaFrontier done = current;
+        current = next;
+        next = done;
     }
 
-  return 0;
+    frontierFree(&current);
+    frontierFree(&next);
+    forestFree(&forest);
+    return accepted;
 }
 
 
@@ -432,7 +353,7 @@ void runTestCases() {
 
         // Run the NPDA transition function
         int len = strlen(input_string_);
-        int result = transition(input_string_, len);
+        int result = transition(input_string_, len, true);
         
         if (result) {
             printf(GREEN "\n==================================================\n" RESET);
@@ -474,17 +395,19 @@ void runTestCases() {
  */
 void runManual() {
 
-    char input_string[MAX_INPUT_SIZE];
+    char *input_string = NULL;
+    size_t capacity = 0;
     char again = 'y';
 
     while (again == 'y' || again == 'Y') {
         printf("============================================\n");
         printf("•Enter a binary palindrome string | Example: 1, 101, 0110, etc. :  \n ");
         
-        scanf("%99s", input_string);
+        if (!readWord(stdin, &input_string, &capacity))
+            break;
 
         if (!validateInput(input_string)) {
-            printf(RED "ERROR: Invalid input! Use only 0s and 1s.\n" RESET);
+            printf(RED "ERROR: Invalid input! Use only %s.\n" RESET, alphabet_list);
             continue;
         }
         else {
@@ -496,7 +419,7 @@ void runManual() {
             printf("Starting NPDA simulation for string: '%s'\n", input_string);
             printf("Simulating non-deterministic transitions...\n\n");
             
-            int result = transition(input_string, len);
+            int result = transition(input_string, len, true);
 
             //Final state check
             if (result) {
@@ -537,9 +460,194 @@ void runManual() {
         scanf(" %c", &again);
         printf("\n");
     }
+    free(input_string);
+}
+
+/*
+ * Check a whole file or stdin as one string, without the 100-character cap
+ *
+ * A palindrome check has to see both halves, so the chunks are gathered
+ * into one growing buffer and the NPDA runs once, without its trace.
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error or invalid input
+ */
+int runStream(const char *path) {
+    InputStream stream;
+    if (streamOpen(&stream, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+
+    char *input = NULL;
+    size_t size = 0, capacity = 0;
+    const char *chunk;
+    size_t len;
+    while ((len = streamRead(&stream, &chunk)) > 0) {
+        if (size + len > capacity) {
+            capacity = (size + len) * 2;
+            char *grown = realloc(input, capacity);
+            if (!grown) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                exit(1);
+            }
+            input = grown;
+        }
+        memcpy(input + size, chunk, len);
+        size += len;
+    }
+
+    int status = 2;
+    if (ferror(stream.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+    } else if (size > INT_MAX) {
+        fprintf(stderr, "Input of %zu characters is too long for the NPDA.\n", size);
+    } else if (!validateInputLength(input, size)) {
+        fprintf(stderr, "ERROR: Invalid input! Use only %s.\n", alphabet_list);
+    } else {
+        int accepted = transition(input ? input : "", (int)size, false);
+        printf("%s: %zu characters\n", accepted ? "ACCEPT" : "REJECT", size);
+        status = accepted ? 0 : 1;
+    }
+    free(input);
+    streamClose(&stream);
+    return status;
 }
 
-int main() {
+/*
+ * Check a whole file as one string, straight from a read-only mapping
+ *
+ * @param path - File to map
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error or invalid input
+ */
+int runMapped(const char *path) {
+    MappedInput input;
+    if (mapInput(&input, path) != 0) {
+        fprintf(stderr, "Cannot map %s: %s\n", path,
+            errno == ENODEV ? "not a regular file, read it with --stream" : strerror(errno));
+        return 2;
+    }
+
+    int status = 2;
+    if (input.len > INT_MAX) {
+        fprintf(stderr, "Input of %zu characters is too long for the NPDA.\n", input.len);
+    } else if (!validateInputLength(input.data, input.len)) {
+        fprintf(stderr, "ERROR: Invalid input! Use only %s.\n", alphabet_list);
+    } else {
+        int accepted = transition(input.data, (int)input.len, false);
+        printf("%s: %zu characters\n", accepted ? "ACCEPT" : "REJECT", input.len);
+        status = accepted ? 0 : 1;
+    }
+    unmapInput(&input);
+    return status;
+}
+
+/*
+ * Non-interactive batch mode: one string per input line, one verdict per
+ * output line ("ACCEPT" or "REJECT"), with no trace, art or colors
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 when every line was checked, 2 on I/O error
+ */
+int runBatch(const char *path) {
+    LineReader reader;
+    if (lineReaderOpen(&reader, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    const char *line;
+    size_t len;
+    while (readLine(&reader, &line, &len)) {
+        bool accepted = len <= INT_MAX && validateInputLength(line, len)
+            && transition(line, (int)len, false);
+        fputs(accepted ? "ACCEPT\n" : "REJECT\n", stdout);
+    }
+
+    int status = 0;
+    if (ferror(reader.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    }
+    lineReaderClose(&reader);
+    fflush(stdout);
+    return status;
+}
+
+/*
+ * Print command-line usage
+ *
+ * @param prog - Program name from argv[0]
+ */
+void printUsage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  (no options)       interactive menu\n");
+    fprintf(stderr, "  --stream [FILE]    check all of FILE (default stdin) as one string\n");
+    fprintf(stderr, "  --mmap FILE        same, reading FILE through a memory mapping\n");
+    fprintf(stderr, "  --batch [FILE]     one string per line in, one ACCEPT/REJECT per line out\n");
+    fprintf(stderr, "  --spec FILE        run the NPDA (or PDA) described in FILE instead (see specs/);\n");
+    fprintf(stderr, "                     on its own, print its transition table\n");
+}
+
+/*
+ * Take an optional file operand following a flag
+ *
+ * @return The operand, or NULL if the next argument is another flag
+ */
+static const char *optionalPath(int argc, char *argv[], int *i) {
+    if (*i + 1 < argc && (argv[*i + 1][0] != '-' || strcmp(argv[*i + 1], "-") == 0))
+        return argv[++(*i)];
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        enum { MODE_NONE, MODE_STREAM, MODE_MMAP, MODE_BATCH } mode = MODE_NONE;
+        const char *path = NULL;
+        const char *spec_path = NULL;
+
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--spec") == 0 && i + 1 < argc) {
+                spec_path = argv[++i];
+            } else if (strcmp(argv[i], "--stream") == 0) {
+                mode = MODE_STREAM;
+                path = optionalPath(argc, argv, &i);
+            } else if (strcmp(argv[i], "--mmap") == 0 && i + 1 < argc) {
+                mode = MODE_MMAP;
+                path = argv[++i];
+            } else if (strcmp(argv[i], "--batch") == 0) {
+                mode = MODE_BATCH;
+                path = optionalPath(argc, argv, &i);
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        if (mode == MODE_NONE && !spec_path) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        if (loadSpec(spec_path) != 0)
+            return 2;
+
+        int status = 0;
+        if (mode == MODE_STREAM)
+            status = runStream(path);
+        else if (mode == MODE_MMAP)
+            status = runMapped(path);
+        else if (mode == MODE_BATCH)
+            status = runBatch(path);
+        else
+            specPrintTable(&desc);
+        unloadSpec();
+        return status;
+    }
+
+    if (loadSpec(NULL) != 0)
+        return 2;
+
     printWelcomeMessage();
     printTransitionTable();
    
@@ -576,5 +684,6 @@ int main() {
     
     printf("\nBye ~~\n");
     printf(RESET);
+    unloadSpec();
     return 0;
 }
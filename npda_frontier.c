@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "npda_frontier.h"
+
+/*
+ * Hash of a whole configuration
+ */
+static uint64_t configHash(const NpdaConfig *conf) {
+    uint64_t hash = (uint64_t)conf->stack * 0xff51afd7ed558ccdull;
+
+    hash ^= (uint64_t)(unsigned)conf->state * 0x9e3779b97f4a7c15ull;
+    hash ^= (uint64_t)(unsigned)conf->input_pos * 0xc2b2ae3d27d4eb4full;
+    return hash ^ (hash >> 29);
+}
+
+static bool configEqual(const NpdaConfig *a, const NpdaConfig *b) {
+    return a->state == b->state && a->input_pos == b->input_pos && a->stack == b->stack;
+}
+
+/*
+ * Slot holding a configuration equal to conf, or the free slot it belongs in
+ */
+static size_t findSlot(const NpdaFrontier *frontier, const NpdaConfig *conf) {
+    size_t mask = frontier->num_slots - 1;
+    size_t slot = (size_t)configHash(conf) & mask;
+
+    while (frontier->slots[slot] && !configEqual(&frontier->configs[frontier->slots[slot] - 1], conf)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void frontierInit(NpdaFrontier *frontier) {
+    frontier->configs = NULL;
+    frontier->count = 0;
+    frontier->capacity = 0;
+    frontier->slots = NULL;
+    frontier->num_slots = 0;
+}
+
+NpdaConfig *frontierAdd(NpdaFrontier *frontier) {
+    if (frontier->count == frontier->capacity) {
+        if (frontier->capacity > INT_MAX / 2) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        int capacity = frontier->capacity ? frontier->capacity * 2 : FRONTIER_INITIAL_CAPACITY;
+        size_t num_slots = (size_t)capacity * 4;
+        NpdaConfig *configs = realloc(frontier->configs, (size_t)capacity * sizeof(NpdaConfig));
+        int *slots = calloc(num_slots, sizeof(int));
+        if (!configs || !slots) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        free(frontier->slots);
+        frontier->configs = configs;
+        frontier->capacity = capacity;
+        frontier->slots = slots;
+        frontier->num_slots = num_slots;
+        // Rehash what is already there
+        for (int i = 0; i < frontier->count; i++) {
+            frontier->slots[findSlot(frontier, &frontier->configs[i])] = i + 1;
+        }
+    }
+    return &frontier->configs[frontier->count];
+}
+
+bool frontierCommit(NpdaFrontier *frontier) {
+    NpdaConfig *conf = &frontier->configs[frontier->count];
+    size_t slot = findSlot(frontier, conf);
+
+    if (frontier->slots[slot])
+        return false;
+    frontier->slots[slot] = ++frontier->count;
+    return true;
+}
+
+void frontierClear(NpdaFrontier *frontier) {
+    // Free only the slots in use, newest first: the probe path of each
+    // configuration runs through slots taken by older ones, so it is still
+    // intact when findSlot() looks for it
+    while (frontier->count > 0) {
+        frontier->count--;
+        frontier->slots[findSlot(frontier, &frontier->configs[frontier->count])] = 0;
+    }
+}
+
+void frontierFree(NpdaFrontier *frontier) {
+    frontierClear(frontier);
+    free(frontier->configs);
+    free(frontier->slots);
+    frontierInit(frontier);
+}
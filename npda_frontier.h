@@ -0,0 +1,89 @@
+#ifndef NPDA_FRONTIER_H
+#define NPDA_FRONTIER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "stack_forest.h"
+
+#define FRONTIER_INITIAL_CAPACITY 64 // configurations allocated by the first add
+
+/*
+ * One path of an NPDA run
+ *
+ * @param state - The state of the path
+ * @param input_pos - Position in the input string
+ * @param stack - The stack of the path, a node of the run's StackForest
+ */
+typedef struct {
+    int state;
+    int input_pos;
+    StackNode stack;
+} NpdaConfig;
+
+/*
+ * One generation of NPDA configurations, without duplicates
+ *
+ * Different paths can reach the same (state, position, stack); from then
+ * on they behave alike, so a configuration already in the generation is
+ * dropped as it is added. Stacks come hash-consed from a StackForest, so
+ * comparing two is comparing their top nodes. The generation grows as
+ * needed, so no path is ever lost to a size limit.
+ *
+ * @param configs - The configurations, in the order they were added
+ * @param count - Number of configurations
+ * @param capacity - Number of configurations configs can hold
+ * @param slots - Open-addressing hash table, index + 1 of a configuration
+ *                or 0 for a free slot
+ * @param num_slots - Size of slots, four times capacity (a power of two)
+ */
+typedef struct {
+    NpdaConfig *configs;
+    int count;
+    int capacity;
+    int *slots;
+    size_t num_slots;
+} NpdaFrontier;
+
+/*
+ * Initialise an empty frontier; nothing is allocated until the first add
+ *
+ * @param frontier - The frontier to initialise
+ */
+void frontierInit(NpdaFrontier *frontier);
+
+/*
+ * Make room for one more configuration
+ *
+ * The caller fills in the returned configuration, then calls
+ * frontierCommit() before adding another.
+ *
+ * @param frontier - The frontier
+ * @return The configuration to fill in, configs[count]
+ */
+NpdaConfig *frontierAdd(NpdaFrontier *frontier);
+
+/*
+ * Keep the configuration filled in after frontierAdd(), unless the
+ * frontier already holds an identical one
+ *
+ * @param frontier - The frontier
+ * @return true if kept, false if it was a duplicate
+ */
+bool frontierCommit(NpdaFrontier *frontier);
+
+/*
+ * Empty the frontier, keeping its storage for the next generation
+ *
+ * @param frontier - The frontier
+ */
+void frontierClear(NpdaFrontier *frontier);
+
+/*
+ * Free a frontier
+ *
+ * @param frontier - The frontier
+ */
+void frontierFree(NpdaFrontier *frontier);
+
+#endif
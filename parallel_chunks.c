@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallel_chunks.h"
+
+int parallelDefaultThreads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+int parallelChunkCount(size_t len, size_t min_chunk, int num_threads) {
+    if (num_threads <= 0)
+        num_threads = parallelDefaultThreads();
+    if ((size_t)num_threads > len / min_chunk)
+        num_threads = (int)(len / min_chunk);
+    return num_threads;
+}
+
+void *parallelSplit(const char *input, size_t len, int num_chunks, int num_states, size_t size) {
+    char *chunks = calloc((size_t)num_chunks, size);
+    if (!chunks) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    size_t chunk_len = len / (size_t)num_chunks;
+    for (int t = 0; t < num_chunks; t++) {
+        ChunkLanes *lanes = (ChunkLanes *)(chunks + (size_t)t * size);
+        lanes->input = input + (size_t)t * chunk_len;
+        lanes->len = t == num_chunks - 1 ? len - (size_t)t * chunk_len : chunk_len;
+        lanes->num_lanes = num_states;
+        for (int s = 0; s < num_states; s++) {
+            lanes->lane[s] = s;
+            lanes->owner[s] = s;
+        }
+    }
+    return chunks;
+}
+
+void parallelRun(void *chunks, int num_chunks, size_t size, void *(*run)(void *)) {
+    char *base = chunks;
+    pthread_t *threads = malloc((size_t)num_chunks * sizeof(pthread_t));
+    if (!threads) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    for (int t = 1; t < num_chunks; t++) {
+        if (pthread_create(&threads[t], NULL, run, base + (size_t)t * size) != 0) {
+            // no thread available, do the chunk on this one
+            run(base + (size_t)t * size);
+            threads[t] = pthread_self();
+        }
+    }
+    run(base);
+    for (int t = 1; t < num_chunks; t++) {
+        if (!pthread_equal(threads[t], pthread_self()))
+            pthread_join(threads[t], NULL);
+    }
+    free(threads);
+}
+
+void parallelMergeLanes(ChunkLanes *lanes, int num_states) {
+    int remap[PARALLEL_MAX_LANES];
+    int kept = 0;
+
+    for (int i = 0; i < lanes->num_lanes; i++) {
+        int j;
+        for (j = 0; j < kept; j++) {
+            if (lanes->lane[j] == lanes->lane[i])
+                break;
+        }
+        if (j == kept)
+            lanes->lane[kept++] = lanes->lane[i];
+        remap[i] = j;
+    }
+    for (int s = 0; s < num_states; s++) {
+        lanes->owner[s] = remap[lanes->owner[s]];
+    }
+    lanes->num_lanes = kept;
+}
@@ -0,0 +1,85 @@
+#ifndef PARALLEL_CHUNKS_H
+#define PARALLEL_CHUNKS_H
+
+#include <stddef.h>
+
+#define PARALLEL_MAX_LANES 64 // speculation only pays off for small machines
+
+/*
+ * Lanes of one chunk of speculative work, shared by dfaRunParallel() and
+ * pdaRunParallel()
+ *
+ * A chunk is run from every state it could be entered in. Each lane
+ * tracks one of those runs; lanes that reach the same state are merged,
+ * and owner says which lane each entry state ended up in. Runners put
+ * this first in their own chunk struct, followed by whatever else they
+ * keep per chunk.
+ *
+ * @param input - First byte of the chunk
+ * @param len - Length of the chunk
+ * @param num_lanes - Distinct states still being tracked
+ * @param lane - Current state of each lane
+ * @param owner - Lane that each entry state maps to
+ */
+typedef struct {
+    const char *input;
+    size_t len;
+    int num_lanes;
+    int lane[PARALLEL_MAX_LANES];
+    int owner[PARALLEL_MAX_LANES];
+} ChunkLanes;
+
+/*
+ * Number of threads to use when the caller does not specify one
+ *
+ * @return Online processor count, at least 1
+ */
+int parallelDefaultThreads(void);
+
+/*
+ * Number of chunks to split an input into
+ *
+ * @param len - Number of input bytes
+ * @param min_chunk - Fewest bytes worth handing to a thread
+ * @param num_threads - Threads asked for, 0 for parallelDefaultThreads()
+ * @return At most num_threads, fewer if the chunks would be shorter than
+ *         min_chunk; below 2 the caller should run sequentially
+ */
+int parallelChunkCount(size_t len, size_t min_chunk, int num_threads);
+
+/*
+ * Allocate the chunks of an input, equal in length but for the last, each
+ * with one lane per state
+ *
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @param num_chunks - Number of chunks
+ * @param num_states - States of the machine, at most PARALLEL_MAX_LANES
+ * @param size - Size of the runner's chunk struct, which starts with a
+ *               ChunkLanes
+ * @return The chunks, to be freed by the caller; other fields are zero
+ */
+void *parallelSplit(const char *input, size_t len, int num_chunks, int num_states, size_t size);
+
+/*
+ * Run every chunk, each on a thread of its own, and wait for them all
+ *
+ * The first chunk runs on the calling thread. A chunk that cannot get a
+ * thread runs on the calling thread too, before the first.
+ *
+ * @param chunks - The chunks from parallelSplit()
+ * @param num_chunks - Number of chunks
+ * @param size - Size of one chunk
+ * @param run - Work for one chunk, given a pointer to it
+ */
+void parallelRun(void *chunks, int num_chunks, size_t size, void *(*run)(void *));
+
+/*
+ * Fold lanes that have reached the same state into one
+ *
+ * @param lanes - The chunk whose lanes are merged
+ * @param num_states - States of the machine
+ */
+void parallelMergeLanes(ChunkLanes *lanes, int num_states);
+
+#endif
@@ -2,6 +2,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include "input_stream.h"
+#include "automaton_spec.h"
+#include "pda_engine.h"
+#include "pda_parallel.h"
+#include "pda_stack.h"
 
 // ANSI color codes
 #define PINK_BG "\033[48;5;218m"
@@ -13,7 +22,8 @@
 #define MAGENTA "\033[35m"
 #define WHITE "\033[37m"
 
-#define MAX_SIZE 1000
+#define SHORT_STACK 64 // symbols kept on the C stack before a PDA stack spills to the heap
+#define PROFILE_BAR 40  // width of the deepest bar in a --profile chart
 /*
  * Define the states of the PDA
  * 
@@ -29,95 +39,31 @@ typedef enum {
     S3  
 } State;
 
-
-/*
- * Define the stack of the PDA
- * 
- * @param items - The items in the stack
- * @param top - The top of the stack
- */
-typedef struct {
-    char *items;
-    int top;
-} Stack;
-
-/*
- * Initialize the stack of the PDA
- * 
- * @param stack - The stack of the PDA
- */
-void initStack(Stack *stack) {
-    stack->items = malloc(MAX_SIZE * sizeof(char));
-    if (!stack->items) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        exit(1);
-    }
-    stack->top = -1;
-}
-
-/*
- * Push a symbol onto the stack
- * 
- * @param stack - The stack of the PDA
- * @param symbol - The symbol to push
- */
-void push(Stack *stack, char symbol) {
-    stack->items[++(stack->top)] = symbol;
-}
-
-/*
- * Pop a symbol from the stack
- * 
- * @param stack - The stack of the PDA
- * @return The symbol popped from the stack
- */
-char pop(Stack *stack) {
-    if (stack->top < 0) {
-        fprintf(stderr, "Stack underflow.\n");
-        exit(1);
-    }
-    return stack->items[(stack->top)--];
-}
-
-/*
- * Peek at the top of the stack
- * 
- * @param stack - The stack of the PDA
- * @return The symbol at the top of the stack
- */
-char peek(Stack *stack) {
-    if (stack->top < 0)
-        return '$';  // treat empty as bottom marker
-    return stack->items[stack->top];
-}
-
-/*
- * Check if the stack is empty
- * 
- * @param stack - The stack of the PDA
- * @return 1 if the stack is empty, 0 otherwise
- */
-int isEmpty(Stack *stack) {
-    return stack->top == -1;
-}
-
-/*
- * Free the stack of the PDA
- * 
- * @param stack - The stack of the PDA
- */
-void freeStack(Stack *stack) {
-    free(stack->items);
-    stack->items = NULL;
-    stack->top = -1;
-}
+// Built-in description of the machine, same format as specs/zeros_ones.pda
+static const char BUILTIN_SPEC[] =
+    "type pda\n"
+    "states S0 S1 S2 S3\n"
+    "alphabet 0 1\n"
+    "stack 0\n"
+    "bottom $\n"
+    "start S0\n"
+    "accept S2\n"
+    "accept-stack bottom\n"
+    "S0 0 * -> S0 push 0\n"
+    "S0 1 $ -> S2\n"
+    "S0 1 0 -> S1 pop\n"
+    "S1 0 * -> S3\n"
+    "S1 1 0 -> S1 pop\n"
+    "S1 1 $ -> S2\n"
+    "S2 * * -> S3\n"
+    "S3 * * -> S3\n";
 
 
 /*
  * Validate input string contains only 0s and 1s
  */
 int validateInput(const char* str) {
-    for (int i = 0; str[i] != '\0'; i++) {
+    for (size_t i = 0; str[i] != '\0'; i++) {
         if (str[i] != '0' && str[i] != '1') {
             return 0;
         }
@@ -139,14 +85,14 @@ State transition(State currentState, Stack *stack, char input) {
                 /// ---- State S0 - Initial state, push phase for 0's ----
                 case S0:
                     if (input == '0' ) {
-                        push(stack, '0');
+                        stackPush(stack, '0');
                         return S0;
                     }                
-                    else if (input == '1' && peek(stack) == '$') {
+                    else if (input == '1' && stackPeek(stack) == '$') {
                         return S2; 
                     }
-                    else if (input == '1' && peek(stack) == '0') {
-                        pop(stack);
+                    else if (input == '1' && stackPeek(stack) == '0') {
+                        stackPop(stack);
                         return S1;
                     }
                    
@@ -156,11 +102,11 @@ State transition(State currentState, Stack *stack, char input) {
                     if (input == '0') {
                         return S3; 
                     }
-                    else if (input == '1' && peek(stack) == '0') {
-                        pop(stack);
+                    else if (input == '1' && stackPeek(stack) == '0') {
+                        stackPop(stack);
                         return S1;
                     }
-                    else if (input == '1' && peek(stack) == '$') {
+                    else if (input == '1' && stackPeek(stack) == '$') {
                         return S2; 
                     }
                     else {
@@ -182,6 +128,48 @@ State transition(State currentState, Stack *stack, char input) {
             }
         }
 
+// Table of the machine being run, built once in main(): the built-in
+// 0^n 1^(n+1) machine, or the one loaded with --spec
+static Pda machine;
+static AutomatonSpec desc;
+static bool have_desc;
+
+// The same machine with its stack replaced by a depth, if pdaBuildCounter() allows
+static PdaCounter counter;
+static bool have_counter;
+
+// Stack of the traced runs, cleared rather than freed between strings
+static char traceItems[SHORT_STACK];
+static Stack traceStack;
+
+// What the non-interactive modes run on, chosen with --engine
+typedef enum {
+    ENGINE_AUTO,     // fastest the machine allows
+    ENGINE_TABLE,    // table and stack
+    ENGINE_COUNTER,  // counter, if the machine has one
+    ENGINE_SIMD,     // pdaZerosOnesSimd(), built-in machine only
+    ENGINE_PARALLEL  // counter, split across all cores for --mmap
+} Engine;
+static Engine engine = ENGINE_AUTO;
+
+// Depth profile of the current run, recorded with --profile
+static PdaProfile profile;
+static bool profiling;
+
+/*
+ * Name of a state of the machine being run
+ *
+ * @param state - The state
+ * @return Its name in the description, or S0..S3 for the built-in machine
+ */
+const char *stateName(int state) {
+    static const char *const builtin[] = { "S0", "S1", "S2", "S3" };
+
+    if (!have_desc)
+        return builtin[state];
+    return state < desc.num_states ? desc.state_names[state] : "(dead)";
+}
+
 /*
  * Print the welcome message and PDA details
  */
@@ -217,23 +205,19 @@ State transition(State currentState, Stack *stack, char input) {
 /*
  * Print the transition table for the PDA
  */
-  void printTransitionTable() {
-           printf("\n" YELLOW "PDA Transition Table:" RESET "\n");
-            printf("┌───────┬─────────┬───────────┬────────────────┬────────────┐\n");
-            printf("│ State │  Input  │ Stack Top │     Action     │ Next State │\n");
-            printf("├───────┼─────────┼───────────┼────────────────┼────────────┤\n");
-            printf("│  S0   │    0    │     -     │   Push 0       │     S0     │\n");
-            printf("│  S0   │    1    │     $     │   No action    │     S2     │\n");
-            printf("│  S0   │    1    │     0     │   Pop 0        │     S1     │\n");
-            printf("│  S1   │    0    │     -     │   Error        │     S3     │\n");
-            printf("│  S1   │    1    │     0     │   Pop 0        │     S1     │\n");
-            printf("│  S1   │    1    │     $     │   No action    │     S2     │\n");
-            printf("│ *S2   │   0/1   │     -     │   Error        │     S3     │\n");
-            printf("│  S3   │   0/1   │     -     │   Stay         │     S3     │\n");
-            printf("└───────┴─────────┴───────────┴────────────────┴────────────┘\n");
-            printf("* denotes accept state\n\n");
-        }
-        
+void printTransitionTable() {
+    AutomatonSpec builtin;
+    char error[256];
+
+    if (specParse(&builtin, BUILTIN_SPEC, error, sizeof(error)) != 0) {
+        fprintf(stderr, "Invalid automaton description: %s\n", error);
+        return;
+    }
+    printf("\n" YELLOW "PDA Transition Table:" RESET "\n");
+    specPrintTable(&builtin);
+    specFree(&builtin);
+}
+
 /*
  * Run test cases mode and display results
  */
@@ -266,12 +250,16 @@ void runTestCases() {
     size_t numTests = sizeof(testCases) / sizeof(testCases[0]);
 
     printf(YELLOW "\n--- Running PDA Test Cases ---\n" RESET);
+
+    char tableItems[SHORT_STACK];
+    PdaStream table;
+    pdaStreamInit(&table, &machine, NULL, tableItems, sizeof(tableItems));
     
     for (size_t i = 0; i < numTests; i++) {
         State currentState = S0;
-        Stack stack;
-        initStack(&stack);
-        push(&stack, '$'); 
+        Stack *stack = &traceStack;
+        stackClear(stack);
+        stackPush(stack, '$'); 
         
         const char* input_string_ = testCases[i].input;
         
@@ -281,26 +269,77 @@ void runTestCases() {
         printf("Start State: S0 | Stack: $ \n");
 
         // Process each character and show transitions
-        for (size_t j = 0; j < strlen(input_string_); j++) {
+        size_t len = strlen(input_string_);
+        size_t deepest = 0;
+        for (size_t j = 0; j < len; j++) {
             char currentChar = input_string_[j];
             
-            currentState = transition(currentState, &stack, currentChar);
+            currentState = transition(currentState, stack, currentChar);
+            if (stack->size - 1 > deepest)
+                deepest = stack->size - 1;
             
             if (currentState == S0){
-                printf("-Read: %c | transitioned to → 'S0'| Stack Top: %c \n", currentChar, peek(&stack));
+                printf("-Read: %c | transitioned to → 'S0'| Stack Top: %c \n", currentChar, stackPeek(stack));
             }
             else if (currentState == S1){
-                printf("-Read: %c | transitioned to → 'S1'| Stack Top: %c \n", currentChar, peek(&stack));
+                printf("-Read: %c | transitioned to → 'S1'| Stack Top: %c \n", currentChar, stackPeek(stack));
             }
             else if (currentState == S2){
-                printf("-Read: %c | transitioned to → 'S2'| Stack Top: %c \n", currentChar, peek(&stack));
+                printf("-Read: %c | transitioned to → 'S2'| Stack Top: %c \n", currentChar, stackPeek(stack));
             }
             else if (currentState == S3){
-                printf("-Read: %c | transitioned to → 'S3'| Stack Top: %c \n", currentChar, peek(&stack));
+                printf("-Read: %c | transitioned to → 'S3'| Stack Top: %c \n", currentChar, stackPeek(stack));
+            }
+            if (pdaIsSink(&machine, currentState) && j + 1 < len) {
+                printf("Stopped early: S%d is a sink, read %zu of %zu characters\n", currentState, j + 1, len);
+                break;
             }
         }
 
-        if (currentState == S2 && peek(&stack) == '$') {
+        // Cross-check the table engine, fed one character at a time ...
+        pdaStreamReset(&table);
+        for (size_t j = 0; j < len && !pdaStreamDone(&table); j++)
+            pdaStreamFeed(&table, input_string_ + j, 1);
+        if (table.state != (int)currentState || table.depth != stack->size - 1) {
+            printf(RED "Table mismatch: switch ended in S%d at depth %zu, table in S%d at depth %" PRIu64 "\n" RESET,
+                currentState, stack->size - 1, table.state, table.depth);
+        }
+        // ... and the counter against the stack
+        if (have_counter) {
+            int counterState = machine.start;
+            uint64_t depth = 0;
+            pdaCounterRun(&counter, &counterState, &depth, input_string_, len);
+            if (counterState != (int)currentState || depth != stack->size - 1) {
+                printf(RED "Counter mismatch: switch ended in S%d at depth %zu, counter in S%d at depth %" PRIu64 "\n" RESET,
+                    currentState, stack->size - 1, counterState, depth);
+            }
+        }
+        // ... and the vectorized kernel, split in two to test resuming
+        int simdState = S0;
+        uint64_t simdDepth = 0;
+        size_t half = len / 2;
+        size_t simdRead = pdaZerosOnesSimd(&simdState, &simdDepth, input_string_, half);
+        if (simdRead == half)
+            pdaZerosOnesSimd(&simdState, &simdDepth, input_string_ + half, len - half);
+        if (simdState != (int)currentState || simdDepth != stack->size - 1) {
+            printf(RED "SIMD mismatch: switch ended in S%d at depth %zu, kernel in S%d at depth %" PRIu64 "\n" RESET,
+                currentState, stack->size - 1, simdState, simdDepth);
+        }
+        // ... and the depth profile against the deepest the trace went
+        char profiledItems[SHORT_STACK];
+        PdaStream profiled;
+        PdaProfile caseProfile;
+        pdaStreamInit(&profiled, &machine, NULL, profiledItems, sizeof(profiledItems));
+        pdaProfileInit(&caseProfile);
+        profiled.profile = &caseProfile;
+        pdaStreamFeed(&profiled, input_string_, len);
+        if (profiled.state != (int)currentState || caseProfile.max_depth != deepest) {
+            printf(RED "Profile mismatch: switch peaked at depth %zu, profile at depth %" PRIu64 "\n" RESET,
+                deepest, caseProfile.max_depth);
+        }
+        pdaStreamFree(&profiled);
+
+        if (currentState == S2 && stackPeek(stack) == '$') {
             printf(GREEN "\n==================================================\n" RESET);
             printf("Final State is S2, Stack is empty. String '%s' is " GREEN "Accepted!\n" RESET, testCases[i].input);
             printf("It's in the language {0^n 1^(n+1)}\n");
@@ -308,14 +347,13 @@ void runTestCases() {
             testCases[i].is_accept = true;
         } else {
             printf(RED "\n**************************************************\n" RESET);
-            printf("Final State is S%d, Stack Top: %c. String '%s' is " RED "Rejected!\n" RESET, currentState, peek(&stack), testCases[i].input);
+            printf("Final State is S%d, Stack Top: %c. String '%s' is " RED "Rejected!\n" RESET, currentState, stackPeek(stack), testCases[i].input);
             printf("It's NOT in the language {0^n 1^(n+1)}\n");
             printf(RED "**************************************************\n" RESET);
             testCases[i].is_accept = false;
         }
-        
-        freeStack(&stack);
     }
+    pdaStreamFree(&table);
 
     // Tabulate results
     printf("┌──────────────────┬────────────────┬──────────┐\n");
@@ -341,50 +379,55 @@ void runTestCases() {
 
 void runManual(){ 
     char again = 'y';
-    char input_string[MAX_SIZE];
+    char *input_string = NULL;
+    size_t capacity = 0;
 
     while (again == 'y' || again == 'Y') {
     printf("============================================\n");
     printf("•Enter a binary string of the language {0^n 1^n+1}  |  Example: 1, 011, 00111, etc. :  \n ");
     
-    scanf("%99s", input_string);
+    if (!readWord(stdin, &input_string, &capacity))
+        break;
 
     printf("\nPROCESSING BINARY STRING...\n");
     printf("-------------------------------------------\n\n");
     
     State currentState = S0;
-    Stack stack;
-           
-    initStack(&stack);
-    push(&stack, '$');
+    Stack *stack = &traceStack;
+    stackClear(stack);
+    stackPush(stack, '$');
  if (!validateInput(input_string)) {
             printf(RED "ERROR: Invalid input! Use only 0s and 1s.\n" RESET);
             continue;}
         else {
     // Current state check
-    int len = strlen(input_string);
-    for (int i = 0; i < len; ++i) {
+    size_t len = strlen(input_string);
+    for (size_t i = 0; i < len; ++i) {
         char currentChar = input_string[i];
         
-        currentState = transition(currentState, &stack, currentChar);
+        currentState = transition(currentState, stack, currentChar);
 
         if (currentState == S0){
-            printf("-Read: %c | transitioned to → 'S0'| Stack Top: %c \n", currentChar, peek(&stack));
+            printf("-Read: %c | transitioned to → 'S0'| Stack Top: %c \n", currentChar, stackPeek(stack));
         }
         else if (currentState == S1){
-            printf("-Read: %c | transitioned to → 'S1'| Stack Top: %c \n", currentChar, peek(&stack));
+            printf("-Read: %c | transitioned to → 'S1'| Stack Top: %c \n", currentChar, stackPeek(stack));
         }
         else if (currentState == S2){
-            printf("-Read: %c | transitioned to → 'S2'| Stack Top: %c \n", currentChar, peek(&stack));
+            printf("-Read: %c | transitioned to → 'S2'| Stack Top: %c \n", currentChar, stackPeek(stack));
         }
         else if (currentState == S3){
-            printf("-Read: %c | transitioned to → 'S3'| Stack Top: %c \n", currentChar, peek(&stack));
+            printf("-Read: %c | transitioned to → 'S3'| Stack Top: %c \n", currentChar, stackPeek(stack));
+        }
+        if (pdaIsSink(&machine, currentState) && i + 1 < len) {
+            printf("-Stopped early: S%d is a sink, read %zu of %zu characters\n", currentState, i + 1, len);
+            break;
         }
     }
 }
 
     //Final state check
-    if (currentState == S2 && peek(&stack) == '$') {
+    if (currentState == S2 && stackPeek(stack) == '$') {
         printf("\n");
         printf("============================================\n");
         printf("Final state for string:  %s → Accepted!\n It's in the language {0^n 1^n+1}\n", input_string);
@@ -421,13 +464,320 @@ void runManual(){
     printf("\nRun again? (y/n): ");
     scanf(" %c", &again);
     printf("\n");
-    freeStack(&stack);
     }
+    free(input_string);
 }
 
 
-int main() {
+/*
+ * Print a depth profile: the peak, then for each bucket its first
+ * character, depth range, and a bar from the shallowest to the deepest
+ *
+ * @param p - The profile
+ */
+void printProfile(const PdaProfile *p) {
+    printf("max stack depth %" PRIu64 " at character %" PRIu64 "\n", p->max_depth, p->max_at);
+    for (int b = 0; b < p->num_buckets; b++) {
+        uint64_t lo = p->max_depth ? p->min[b] * PROFILE_BAR / p->max_depth : 0;
+        uint64_t hi = p->max_depth ? p->max[b] * PROFILE_BAR / p->max_depth : 0;
+        printf("%12" PRIu64 " %12" PRIu64 "..%-12" PRIu64 " ", (uint64_t)b * p->bucket_width, p->min[b], p->max[b]);
+        for (uint64_t col = 0; col <= hi; col++)
+            putchar(col < lo ? ' ' : '#');
+        putchar('\n');
+    }
+}
+
+/*
+ * Print the verdict and final configuration of a run
+ *
+ * @param run - The finished run
+ * @return true if the input was accepted
+ */
+bool report(const PdaStream *run) {
+    bool accepted = pdaStreamAccepts(run);
+
+    printf("%s: final state %s, stack depth %" PRIu64 " after %" PRIu64 " characters%s\n",
+        accepted ? "ACCEPT" : "REJECT", stateName(run->state), run->depth, run->consumed,
+        pdaStreamDone(run) ? " (stopped at sink)" : "");
+    if (run->profile)
+        printProfile(run->profile);
+    return accepted;
+}
+
+/*
+ * Start a run of the machine on the engine chosen with --engine
+ *
+ * @param run - The run to initialise
+ * @param items - Storage for the stack until it outgrows it
+ * @param size - Size of items in bytes
+ */
+void startRun(PdaStream *run, char *items, size_t size) {
+    bool use_counter = have_counter && engine != ENGINE_TABLE;
+
+    pdaStreamInit(run, &machine, use_counter ? &counter : NULL, items, size);
+    if (use_counter && !have_desc && (engine == ENGINE_AUTO || engine == ENGINE_SIMD))
+        run->kernel = pdaZerosOnesSimd;
+    if (profiling) {
+        pdaProfileInit(&profile);
+        run->profile = &profile;
+    }
+}
+
+/*
+ * Check a whole file or stdin as one string, without the 100-character cap
+ *
+ * Reads in STREAM_CHUNK_SIZE pieces and feeds them to a PdaStream, so
+ * memory use is bounded by the stack depth (constant on the counter), not
+ * the input length.
+ * Reading stops as soon as the PDA enters a sink.
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error
+ */
+int runStream(const char *path) {
+    InputStream stream;
+    if (streamOpen(&stream, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+
+    char items[SHORT_STACK];
+    PdaStream run;
+    startRun(&run, items, sizeof(items));
+
+    const char *chunk;
+    size_t len;
+    // Stop reading once a sink settles the result
+    while (!pdaStreamDone(&run) && (len = streamRead(&stream, &chunk)) > 0) {
+        pdaStreamFeed(&run, chunk, len);
+    }
+
+    int status;
+    if (ferror(stream.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    } else {
+        status = report(&run) ? 0 : 1;
+    }
+    pdaStreamFree(&run);
+    streamClose(&stream);
+    return status;
+}
+
+/*
+ * Check a whole file as one string, straight from a read-only mapping
+ *
+ * On the counter the mapped input is split across all cores by
+ * pdaRunParallel(), unless --engine counter asks for one.
+ *
+ * @param path - File to map
+ * @return 0 if accepted, 1 if rejected, 2 on I/O error
+ */
+int runMapped(const char *path) {
+    MappedInput input;
+    if (mapInput(&input, path) != 0) {
+        fprintf(stderr, "Cannot map %s: %s\n", path,
+            errno == ENODEV ? "not a regular file, read it with --stream" : strerror(errno));
+        return 2;
+    }
+
+    char items[SHORT_STACK];
+    PdaStream run;
+    startRun(&run, items, sizeof(items));
+    if (run.counter && !run.kernel && !run.profile && engine != ENGINE_COUNTER) {
+        // Walk the first block alone: inputs that hit a sink early never start the threads
+        size_t prefix = input.len < PDA_PARALLEL_MIN_CHUNK ? input.len : PDA_PARALLEL_MIN_CHUNK;
+        pdaStreamFeed(&run, input.data, prefix);
+        if (run.consumed == prefix && !pdaStreamDone(&run))
+            run.consumed += pdaRunParallel(run.counter, &run.state, &run.depth, input.data + prefix, input.len - prefix, 0);
+    } else {
+        pdaStreamFeed(&run, input.data, input.len);
+    }
+    bool accepted = report(&run);
+    pdaStreamFree(&run);
+    unmapInput(&input);
+    return accepted ? 0 : 1;
+}
+
+/*
+ * Non-interactive batch mode: one string per input line, one verdict per
+ * output line ("ACCEPT" or "REJECT"), with no trace, art or colors
+ *
+ * @param path - File to read, NULL for stdin
+ * @return 0 when every line was checked, 2 on I/O error
+ */
+int runBatch(const char *path) {
+    LineReader reader;
+    if (lineReaderOpen(&reader, path) != 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    // One run for every line, reset in between, so the stack is allocated
+    // at most a few times over the whole batch
+    char items[SHORT_STACK];
+    PdaStream run;
+    startRun(&run, items, sizeof(items));
+
+    const char *line;
+    size_t len;
+    while (readLine(&reader, &line, &len)) {
+        pdaStreamReset(&run);
+        if (profiling)
+            pdaProfileInit(&profile);
+        pdaStreamFeed(&run, line, len);
+        fputs(pdaStreamAccepts(&run) ? "ACCEPT" : "REJECT", stdout);
+        if (profiling)
+            printf(" max-depth %" PRIu64, profile.max_depth);
+        putchar('\n');
+    }
+    pdaStreamFree(&run);
+
+    int status = 0;
+    if (ferror(reader.file)) {
+        fprintf(stderr, "Read error: %s\n", strerror(errno));
+        status = 2;
+    }
+    lineReaderClose(&reader);
+    fflush(stdout);
+    return status;
+}
+
+/*
+ * Print command-line usage
+ *
+ * @param prog - Program name from argv[0]
+ */
+void printUsage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  (no options)       interactive menu\n");
+    fprintf(stderr, "  --stream [FILE]    check all of FILE (default stdin) as one string\n");
+    fprintf(stderr, "  --mmap FILE        same, reading FILE through a memory mapping\n");
+    fprintf(stderr, "  --batch [FILE]     one string per line in, one ACCEPT/REJECT per line out\n");
+    fprintf(stderr, "  --spec FILE        run the PDA described in FILE instead (see specs/);\n");
+    fprintf(stderr, "                     on its own, print its transition table\n");
+    fprintf(stderr, "  --engine NAME      table, counter, simd (built-in machine only), parallel\n");
+    fprintf(stderr, "                     (counter on all cores for --mmap) or auto, the default:\n");
+    fprintf(stderr, "                     simd, else parallel if possible, else table\n");
+    fprintf(stderr, "  --profile          record stack depth per character: peak and depth chart\n");
+    fprintf(stderr, "                     after --stream/--mmap, peak per line after --batch\n");
+}
+
+/*
+ * Take an optional file operand following a flag
+ *
+ * @return The operand, or NULL if the next argument is another flag
+ */
+static const char *optionalPath(int argc, char *argv[], int *i) {
+    if (*i + 1 < argc && (argv[*i + 1][0] != '-' || strcmp(argv[*i + 1], "-") == 0))
+        return argv[++(*i)];
+    return NULL;
+}
+
+/*
+ * Load a PDA description and build its table
+ *
+ * @param path - The description file
+ * @return 0 on success, -1 after printing the reason
+ */
+int loadSpec(const char *path) {
+    char error[512];
+
+    if (specLoad(&desc, path, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s\n", error);
+        return -1;
+    }
+    if (specBuildPda(&desc, &machine, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", path, error);
+        specFree(&desc);
+        return -1;
+    }
+    have_desc = true;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        enum { MODE_NONE, MODE_STREAM, MODE_MMAP, MODE_BATCH } mode = MODE_NONE;
+        const char *path = NULL;
+        const char *spec_path = NULL;
+
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--spec") == 0 && i + 1 < argc) {
+                spec_path = argv[++i];
+            } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+                static const char *const names[] = { "auto", "table", "counter", "simd", "parallel" };
+                const char *name = argv[++i];
+                int num_names = (int)(sizeof(names) / sizeof(names[0]));
+                int e = 0;
+                while (e < num_names && strcmp(name, names[e]) != 0)
+                    e++;
+                if (e == num_names) {
+                    printUsage(argv[0]);
+                    return 2;
+                }
+                engine = (Engine)e;
+            } else if (strcmp(argv[i], "--profile") == 0) {
+                profiling = true;
+            } else if (strcmp(argv[i], "--stream") == 0) {
+                mode = MODE_STREAM;
+                path = optionalPath(argc, argv, &i);
+            } else if (strcmp(argv[i], "--mmap") == 0 && i + 1 < argc) {
+                mode = MODE_MMAP;
+                path = argv[++i];
+            } else if (strcmp(argv[i], "--batch") == 0) {
+                mode = MODE_BATCH;
+                path = optionalPath(argc, argv, &i);
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        if (spec_path && loadSpec(spec_path) != 0)
+            return 2;
+        if (mode == MODE_NONE && !spec_path) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        if (mode == MODE_NONE) {
+            specPrintTable(&desc);
+            pdaFree(&machine);
+            specFree(&desc);
+            return 0;
+        }
+        if (!have_desc)
+            pdaBuildZerosOnes(&machine);
+        have_counter = pdaBuildCounter(&machine, &counter);
+
+        int status;
+        bool needs_counter = engine == ENGINE_COUNTER || engine == ENGINE_PARALLEL;
+        if ((engine == ENGINE_SIMD && have_desc) || (needs_counter && !have_counter)) {
+            fprintf(stderr, "The %s engine cannot run this machine.\n",
+                engine == ENGINE_SIMD ? "simd" : engine == ENGINE_COUNTER ? "counter" : "parallel");
+            status = 2;
+        } else if (mode == MODE_STREAM) {
+            status = runStream(path);
+        } else if (mode == MODE_MMAP) {
+            status = runMapped(path);
+        } else {
+            status = runBatch(path);
+        }
+        if (have_counter)
+            pdaCounterFree(&counter);
+        pdaFree(&machine);
+        if (have_desc)
+            specFree(&desc);
+        return status;
+    }
+
+    pdaBuildZerosOnes(&machine);
+    have_counter = pdaBuildCounter(&machine, &counter);
+    stackInit(&traceStack, traceItems, sizeof(traceItems));
+
     printWelcomeMessage();
+    printTransitionTable();
    
     int menuChoice = 0;
 
@@ -458,6 +808,7 @@ int main() {
     } while (menuChoice != 3);
     
     
+    stackFree(&traceStack);
     printf("Bye ~~\n");
     // Reset color
     printf(RESET);
@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_features.h"
+#include "pda_engine.h"
+
+#define COUNTER_PROBE_DEPTH 2 // counted symbols on the stack when probing a nonzero depth
+
+void pdaInit(Pda *pda, int num_states, const char *symbols, int num_symbols, int start, int fallback) {
+    int num_tops = num_symbols + 1;
+    size_t cells = (size_t)num_states * num_tops * PDA_SYMBOLS;
+
+    pda->moves = malloc(cells * sizeof(PdaMove));
+    pda->actions = calloc(1, sizeof(PdaAction));
+    pda->accept = calloc((size_t)num_states, 1);
+    pda->loops = calloc((size_t)num_states, sizeof(uint32_t));
+    if (!pda->moves || !pda->actions || !pda->accept || !pda->loops) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < cells; i++) {
+        pda->moves[i].next = (uint16_t)fallback;
+        pda->moves[i].action = 0;
+    }
+    // Symbols that are never pushed cannot be on top; give them the empty column
+    memset(pda->top_of, num_tops - 1, sizeof(pda->top_of));
+    for (int i = 0; i < num_symbols; i++) {
+        pda->top_of[(unsigned char)symbols[i]] = (uint8_t)i;
+    }
+    pda->loops[fallback] = (uint32_t)num_tops * PDA_SYMBOLS;
+    pda->num_states = num_states;
+    pda->num_tops = num_tops;
+    pda->start = start;
+    pda->bottom = -1;
+    pda->accept_stack = ACCEPT_STACK_ANY;
+    pda->num_actions = 1;
+}
+
+void pdaFree(Pda *pda) {
+    free(pda->moves);
+    free(pda->actions);
+    free(pda->accept);
+    free(pda->loops);
+    pda->moves = NULL;
+    pda->actions = NULL;
+    pda->accept = NULL;
+    pda->loops = NULL;
+    pda->num_states = 0;
+    pda->num_actions = 0;
+}
+
+int pdaAction(Pda *pda, bool pop, const char *push) {
+    PdaAction action;
+    size_t len = strlen(push);
+
+    if (len > PDA_MAX_PUSH) {
+        fprintf(stderr, "Too many symbols pushed at once.\n");
+        exit(1);
+    }
+    memset(&action, 0, sizeof(action));
+    action.pop = pop;
+    action.push_len = (uint8_t)len;
+    memcpy(action.push, push, len);
+
+    for (int i = 0; i < pda->num_actions; i++) {
+        if (memcmp(&pda->actions[i], &action, sizeof(action)) == 0)
+            return i;
+    }
+    if (pda->num_actions > UINT16_MAX) {
+        fprintf(stderr, "Too many distinct stack actions.\n");
+        exit(1);
+    }
+    // Capacity doubles each time the count reaches a power of two
+    if ((pda->num_actions & (pda->num_actions - 1)) == 0) {
+        PdaAction *grown = realloc(pda->actions, (size_t)pda->num_actions * 2 * sizeof(PdaAction));
+        if (!grown) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+        pda->actions = grown;
+    }
+    pda->actions[pda->num_actions] = action;
+    return pda->num_actions++;
+}
+
+void pdaSetTransition(Pda *pda, int from, int top, unsigned char symbol, int to, int action) {
+    int column = top == PDA_EMPTY_STACK ? pda->num_tops - 1 : pda->top_of[(unsigned char)top];
+    PdaMove *cell = &pda->moves[((size_t)from * pda->num_tops + column) * PDA_SYMBOLS + symbol];
+
+    pda->loops[from] -= (uint32_t)(cell->next == from && cell->action == 0);
+    pda->loops[from] += (uint32_t)(to == from && action == 0);
+    cell->next = (uint16_t)to;
+    cell->action = (uint16_t)action;
+}
+
+int pdaReset(const Pda *pda, Stack *stack) {
+    stackClear(stack);
+    if (pda->bottom >= 0)
+        stackPush(stack, (char)pda->bottom);
+    return pda->start;
+}
+
+size_t pdaRunUntilSink(const Pda *pda, int *state, Stack *stack, const char *input, size_t len) {
+    int s = *state;
+    size_t i = 0;
+
+    while (i < len && !pdaIsSink(pda, s)) {
+        s = pdaStep(pda, s, stack, (unsigned char)input[i++]);
+    }
+    *state = s;
+    return i;
+}
+
+bool pdaIsAccepting(const Pda *pda, int state, const Stack *stack) {
+    if (!pda->accept[state])
+        return false;
+    switch (pda->accept_stack) {
+        case ACCEPT_STACK_BOTTOM:
+            return stack->size == 1 && stack->items[0] == (char)pda->bottom;
+        case ACCEPT_STACK_EMPTY:
+            return stack->size == 0;
+        default:
+            return true;
+    }
+}
+
+void pdaBuildZerosOnes(Pda *pda) {
+    enum { S0, S1, S2, S3 };
+
+    pdaInit(pda, 4, "$0", 2, S0, S3);
+    pda->bottom = '$';
+    pda->accept_stack = ACCEPT_STACK_BOTTOM;
+    int push = pdaAction(pda, false, "0");
+    int pop = pdaAction(pda, true, "");
+
+    pdaSetTransition(pda, S0, '$', '0', S0, push);
+    pdaSetTransition(pda, S0, '0', '0', S0, push);
+    pdaSetTransition(pda, S0, '$', '1', S2, 0);
+    pdaSetTransition(pda, S0, '0', '1', S1, pop);
+    pdaSetTransition(pda, S1, '0', '1', S1, pop);
+    pdaSetTransition(pda, S1, '$', '1', S2, 0);
+    // Everything else, including any byte after the extra '1', leads to the S3 sink
+
+    pda->accept[S2] = 1;
+}
+
+// ---- Counter specialization ----
+
+/*
+ * Try one move on a stack holding the bottom and depth counted symbols
+ *
+ * @param symbol - The counted symbol, -1 while none has been pushed yet;
+ *                 set by the first move that pushes one
+ * @return false if the move does something a counter cannot
+ */
+static bool probeCounter(const Pda *pda, PdaCounter *counter, int *symbol, int state, int nonzero, unsigned char c) {
+    char items[COUNTER_PROBE_DEPTH + 1 + PDA_MAX_PUSH];
+    size_t depth = nonzero ? COUNTER_PROBE_DEPTH : 0;
+    size_t base = (size_t)counter->base;
+    Stack probe;
+
+    stackInit(&probe, items, sizeof(items));
+    pdaReset(pda, &probe);
+    for (size_t i = 0; i < depth; i++)
+        stackPush(&probe, (char)*symbol);
+    int next = pdaStep(pda, state, &probe, c);
+
+    // The bottom still in place, at most one symbol popped or pushed ...
+    bool ok = probe.size >= base && (base == 0 || probe.items[0] == (char)pda->bottom);
+    size_t after = ok ? probe.size - base : 0;
+    ok = ok && after + 1 >= depth && after <= depth + 1;
+    if (ok && after > depth && *symbol < 0)
+        *symbol = (unsigned char)probe.items[probe.size - 1];
+    // ... and everything above it the counted symbol
+    for (size_t i = base; ok && i < probe.size; i++)
+        ok = probe.items[i] == (char)*symbol && *symbol != pda->bottom;
+    if (ok) {
+        size_t cell = ((size_t)state * 2 + nonzero) * PDA_SYMBOLS + c;
+        counter->next[cell] = (uint16_t)next;
+        counter->delta[cell] = (int8_t)((long)after - (long)depth);
+    }
+    stackFree(&probe);
+    return ok;
+}
+
+bool pdaBuildCounter(const Pda *pda, PdaCounter *counter) {
+    size_t cells = (size_t)pda->num_states * 2 * PDA_SYMBOLS;
+    int symbol = -1;
+    bool ok = true;
+
+    counter->pda = pda;
+    counter->base = pda->bottom >= 0 ? 1 : 0;
+    counter->next = malloc(cells * sizeof(uint16_t));
+    counter->delta = malloc(cells);
+    if (!counter->next || !counter->delta) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+
+    for (int nonzero = 0; nonzero <= 1 && ok; nonzero++) {
+        for (int s = 0; s < pda->num_states && ok; s++) {
+            for (int c = 0; c < PDA_SYMBOLS && ok; c++) {
+                if (nonzero && symbol < 0) {
+                    // Nothing is ever pushed, so the depth never leaves 0
+                    size_t cell = (size_t)s * 2 * PDA_SYMBOLS + c;
+                    counter->next[cell + PDA_SYMBOLS] = counter->next[cell];
+                    counter->delta[cell + PDA_SYMBOLS] = counter->delta[cell];
+                } else {
+                    ok = probeCounter(pda, counter, &symbol, s, nonzero, (unsigned char)c);
+                }
+            }
+        }
+    }
+    if (!ok) {
+        pdaCounterFree(counter);
+        return false;
+    }
+    counter->symbol = (char)(symbol < 0 ? 0 : symbol);
+    return true;
+}
+
+void pdaCounterFree(PdaCounter *counter) {
+    free(counter->next);
+    free(counter->delta);
+    counter->next = NULL;
+    counter->delta = NULL;
+}
+
+size_t pdaCounterRun(const PdaCounter *counter, int *state, uint64_t *depth, const char *input, size_t len) {
+    const Pda *pda = counter->pda;
+    int s = *state;
+    uint64_t n = *depth;
+    size_t i = 0;
+
+    while (i < len && !pdaIsSink(pda, s)) {
+        size_t cell = ((size_t)s * 2 + (n > 0)) * PDA_SYMBOLS + (unsigned char)input[i++];
+        n += (uint64_t)(int64_t)counter->delta[cell];
+        s = counter->next[cell];
+    }
+    *state = s;
+    *depth = n;
+    return i;
+}
+
+bool pdaCounterAccepts(const PdaCounter *counter, int state, uint64_t depth) {
+    const Pda *pda = counter->pda;
+
+    if (!pda->accept[state])
+        return false;
+    switch (pda->accept_stack) {
+        case ACCEPT_STACK_BOTTOM:
+            return depth == 0 && counter->base == 1;
+        case ACCEPT_STACK_EMPTY:
+            return depth == 0 && counter->base == 0;
+        default:
+            return true;
+    }
+}
+
+// ---- Vectorized kernel for the 0^n 1^(n+1) language ----
+
+#if defined(__GNUC__)
+#define CTZ64(x) ((unsigned)__builtin_ctzll(x))
+#else
+static unsigned CTZ64(uint64_t x) {
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+#endif
+
+/*
+ * Scalar tail: length of the run of byte c at the start of p
+ */
+static size_t spanScalar(const unsigned char *p, size_t len, unsigned char c) {
+    size_t i = 0;
+    while (i < len && p[i] == c)
+        i++;
+    return i;
+}
+
+#ifdef CPU_HAVE_AVX2
+__attribute__((target("avx2")))
+static size_t spanAvx2(const unsigned char *p, size_t len, unsigned char c) {
+    const __m256i want = _mm256_set1_epi8((char)c);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        uint64_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i)), want));
+        uint64_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i + 32)), want));
+        uint64_t other = ~(lo | hi << 32);
+        if (other)
+            return i + CTZ64(other);
+    }
+    return i + spanScalar(p + i, len - i, c);
+}
+#endif
+
+#ifdef CPU_HAVE_SSE2
+static size_t spanSse2(const unsigned char *p, size_t len, unsigned char c) {
+    const __m128i want = _mm_set1_epi8((char)c);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        uint64_t m0 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), want));
+        uint64_t m1 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 16)), want));
+        uint64_t m2 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 32)), want));
+        uint64_t m3 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + 48)), want));
+        uint64_t other = ~(m0 | m1 << 16 | m2 << 32 | m3 << 48);
+        if (other)
+            return i + CTZ64(other);
+    }
+    return i + spanScalar(p + i, len - i, c);
+}
+#endif
+
+#ifdef CPU_HAVE_NEON
+static size_t spanNeon(const unsigned char *p, size_t len, unsigned char c) {
+    const uint8x16_t want = vdupq_n_u8(c);
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        uint8x16x4_t v = vld1q_u8_x4(p + i);
+        uint8x16_t all = vandq_u8(vandq_u8(vceqq_u8(v.val[0], want), vceqq_u8(v.val[1], want)),
+                                  vandq_u8(vceqq_u8(v.val[2], want), vceqq_u8(v.val[3], want)));
+        // No movemask on NEON: find the block that breaks the run, then scan it
+        if (vminvq_u8(all) == 0)
+            return i + spanScalar(p + i, 64, c);
+    }
+    return i + spanScalar(p + i, len - i, c);
+}
+#endif
+
+/*
+ * Length of the run of byte c at the start of p, best vector unit available
+ */
+static size_t span(const unsigned char *p, size_t len, unsigned char c) {
+#if defined(CPU_HAVE_AVX2)
+    if (cpuHasAvx2())
+        return spanAvx2(p, len, c);
+#endif
+#if defined(CPU_HAVE_SSE2)
+    return spanSse2(p, len, c);
+#elif defined(CPU_HAVE_NEON)
+    return spanNeon(p, len, c);
+#else
+    return spanScalar(p, len, c);
+#endif
+}
+
+size_t pdaZerosOnesSimd(int *state, uint64_t *depth, const char *input, size_t len) {
+    enum { S0, S1, S2, S3 };
+    const unsigned char *p = (const unsigned char *)input;
+    int s = *state;
+    uint64_t d = *depth;
+    size_t i = 0;
+
+    while (i < len && s != S3) {
+        size_t run;
+        switch (s) {
+            case S0:
+                // Push the '0's, then the first other byte decides
+                run = span(p + i, len - i, '0');
+                d += run;
+                i += run;
+                if (i == len)
+                    break;
+                if (p[i++] != '1')
+                    s = S3;
+                else if (d == 0)
+                    s = S2;
+                else {
+                    d--;
+                    s = S1;
+                }
+                break;
+            case S1:
+                // Pop a '0' per '1'; the one after the last '0' is the extra '1'
+                run = span(p + i, len - i, '1');
+                if (run <= d) {
+                    d -= run;
+                    i += run;
+                    if (i < len) {
+                        i++;   // a '0' or a stray byte
+                        s = S3;
+                    }
+                } else {
+                    i += (size_t)d + 1;
+                    d = 0;
+                    s = S2;
+                }
+                break;
+            default:
+                // Nothing may follow the extra '1'
+                i++;
+                s = S3;
+                break;
+        }
+    }
+    *state = s;
+    *depth = d;
+    return i;
+}
+
+// ---- Streaming ----
+
+void pdaProfileInit(PdaProfile *profile) {
+    memset(profile, 0, sizeof(*profile));
+    profile->bucket_width = 1;
+}
+
+/*
+ * Add the depth after one character to a profile
+ *
+ * @param profile - The profile
+ * @param pos - Index of the character, one more than the last one recorded
+ * @param depth - Depth after it
+ */
+static void profileRecord(PdaProfile *profile, uint64_t pos, uint64_t depth) {
+    if (pos >= profile->bucket_end && profile->num_buckets == PDA_PROFILE_BUCKETS) {
+        // Out of buckets: halve the resolution
+        for (int i = 0; i < PDA_PROFILE_BUCKETS / 2; i++) {
+            uint64_t lo = profile->min[2 * i + 1], hi = profile->max[2 * i + 1];
+            profile->min[i] = profile->min[2 * i] < lo ? profile->min[2 * i] : lo;
+            profile->max[i] = profile->max[2 * i] > hi ? profile->max[2 * i] : hi;
+        }
+        profile->num_buckets = PDA_PROFILE_BUCKETS / 2;
+        profile->bucket_width *= 2;
+    }
+    if (pos >= profile->bucket_end) {
+        int b = profile->num_buckets++;
+        profile->min[b] = profile->max[b] = depth;
+        profile->bucket_end += profile->bucket_width;
+    } else {
+        int b = profile->num_buckets - 1;
+        if (depth < profile->min[b])
+            profile->min[b] = depth;
+        if (depth > profile->max[b])
+            profile->max[b] = depth;
+    }
+    if (depth > profile->max_depth) {
+        profile->max_depth = depth;
+        profile->max_at = pos;
+    }
+}
+
+void pdaStreamInit(PdaStream *run, const Pda *pda, const PdaCounter *counter, char *buffer, size_t buffer_size) {
+    run->pda = pda;
+    run->counter = counter;
+    run->kernel = NULL;
+    run->profile = NULL;
+    run->depth = 0;
+    run->consumed = 0;
+    stackInit(&run->stack, buffer, buffer_size);
+    run->state = pdaReset(pda, &run->stack);
+}
+
+void pdaStreamReset(PdaStream *run) {
+    run->depth = 0;
+    run->consumed = 0;
+    run->state = pdaReset(run->pda, &run->stack);
+}
+
+/*
+ * Run a chunk one character at a time, recording the depth after each
+ *
+ * @param run - The run, with a profile
+ * @param chunk - The chunk
+ * @param len - Length of the chunk
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+static size_t feedProfiled(PdaStream *run, const char *chunk, size_t len) {
+    const Pda *pda = run->pda;
+    size_t i = 0;
+
+    while (i < len && !pdaIsSink(pda, run->state)) {
+        if (run->counter) {
+            pdaCounterRun(run->counter, &run->state, &run->depth, chunk + i, 1);
+        } else {
+            run->state = pdaStep(pda, run->state, &run->stack, (unsigned char)chunk[i]);
+            size_t base = pda->bottom >= 0 && run->stack.size > 0;
+            run->depth = (uint64_t)(run->stack.size - base);
+        }
+        profileRecord(run->profile, run->consumed + i, run->depth);
+        i++;
+    }
+    return i;
+}
+
+size_t pdaStreamFeed(PdaStream *run, const char *chunk, size_t len) {
+    size_t consumed;
+
+    if (run->profile) {
+        consumed = feedProfiled(run, chunk, len);
+    } else if (run->kernel) {
+        consumed = run->kernel(&run->state, &run->depth, chunk, len);
+    } else if (run->counter) {
+        consumed = pdaCounterRun(run->counter, &run->state, &run->depth, chunk, len);
+    } else {
+        consumed = pdaRunUntilSink(run->pda, &run->state, &run->stack, chunk, len);
+        size_t base = run->pda->bottom >= 0 && run->stack.size > 0;
+        run->depth = (uint64_t)(run->stack.size - base);
+    }
+    run->consumed += consumed;
+    return consumed;
+}
+
+bool pdaStreamAccepts(const PdaStream *run) {
+    if (run->counter)
+        return pdaCounterAccepts(run->counter, run->state, run->depth);
+    return pdaIsAccepting(run->pda, run->state, &run->stack);
+}
+
+void pdaStreamFree(PdaStream *run) {
+    stackFree(&run->stack);
+}
@@ -0,0 +1,413 @@
+#ifndef PDA_ENGINE_H
+#define PDA_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pda_stack.h"
+
+#define PDA_SYMBOLS 256       // one table column per input byte
+#define PDA_MAX_STATES 65535
+#define PDA_MAX_PUSH 8        // symbols pushed by one move
+#define PDA_EMPTY_STACK (-1)  // "top" of an empty stack
+#define PDA_PROFILE_BUCKETS 64 // depth samples kept by a PdaProfile
+
+typedef enum {
+    ACCEPT_STACK_ANY,     // final state alone decides
+    ACCEPT_STACK_BOTTOM,  // stack must be back at the bottom marker
+    ACCEPT_STACK_EMPTY    // stack must be empty
+} AcceptStack;
+
+/*
+ * One cell of the table: where a (state, stack top, byte) goes
+ *
+ * @param next - Target state
+ * @param action - Index into the action list, 0 leaves the stack alone
+ */
+typedef struct {
+    uint16_t next;
+    uint16_t action;
+} PdaMove;
+
+/*
+ * Stack effect of a move: an optional pop followed by some pushes
+ *
+ * @param pop - Pop the top first
+ * @param push_len - Number of symbols pushed
+ * @param push - The symbols in push order, the last one ends on top
+ */
+typedef struct {
+    bool pop;
+    uint8_t push_len;
+    char push[PDA_MAX_PUSH];
+} PdaAction;
+
+/*
+ * Table-driven deterministic PDA
+ *
+ * Each stack symbol, the bottom marker included, has a column number;
+ * the last column, num_tops - 1, stands for an empty stack. A step is one
+ * lookup keyed on (state, top column, input byte) plus, for moves that
+ * touch the stack, the action it names.
+ *
+ * @param num_states - Number of states, numbered 0 .. num_states-1
+ * @param num_tops - Number of stack symbols plus one for the empty stack
+ * @param start - The initial state
+ * @param bottom - Marker pushed before every run, -1 for none
+ * @param accept_stack - What the stack must hold for an accept
+ * @param top_of - Column of each stack symbol
+ * @param moves - moves[(state * num_tops + top) * PDA_SYMBOLS + byte]
+ * @param actions - Distinct stack effects, actions[0] does nothing
+ * @param num_actions - Number of actions in use
+ * @param accept - Nonzero for accepting states
+ * @param loops - Number of (top, byte) pairs leading each state back to
+ *                itself without an action; num_tops * PDA_SYMBOLS marks a sink
+ */
+typedef struct {
+    int num_states;
+    int num_tops;
+    int start;
+    int bottom;
+    AcceptStack accept_stack;
+    uint8_t top_of[256];
+    PdaMove *moves;
+    PdaAction *actions;
+    int num_actions;
+    uint8_t *accept;
+    uint32_t *loops;
+} Pda;
+
+/*
+ * Allocate a PDA whose moves all lead to one fallback state
+ *
+ * @param pda - The PDA to initialise
+ * @param num_states - Number of states
+ * @param symbols - The stack symbols, bottom marker included
+ * @param num_symbols - Number of stack symbols
+ * @param start - The initial state
+ * @param fallback - Target of every move not set explicitly
+ */
+void pdaInit(Pda *pda, int num_states, const char *symbols, int num_symbols, int start, int fallback);
+
+/*
+ * Free the tables of a PDA
+ *
+ * @param pda - The PDA to free
+ */
+void pdaFree(Pda *pda);
+
+/*
+ * Find or add a stack action
+ *
+ * @param pda - The PDA
+ * @param pop - Pop the top first
+ * @param push - Symbols to push in order, NUL-terminated, at most
+ *               PDA_MAX_PUSH of them
+ * @return Index of the action, 0 for one that does nothing
+ */
+int pdaAction(Pda *pda, bool pop, const char *push);
+
+/*
+ * Set one move of the PDA
+ *
+ * @param pda - The PDA
+ * @param from - Source state
+ * @param top - Stack symbol on top, or PDA_EMPTY_STACK
+ * @param symbol - Input byte
+ * @param to - Target state
+ * @param action - Index returned by pdaAction()
+ */
+void pdaSetTransition(Pda *pda, int from, int top, unsigned char symbol, int to, int action);
+
+/*
+ * Column of the symbol on top of a stack
+ *
+ * @param pda - The PDA
+ * @param stack - The stack
+ * @return The column, num_tops - 1 for an empty stack
+ */
+static inline int pdaTop(const Pda *pda, const Stack *stack) {
+    if (stack->size == 0)
+        return pda->num_tops - 1;
+    return pda->top_of[(unsigned char)stack->items[stack->size - 1]];
+}
+
+/*
+ * Single move: one table lookup, then the stack action if there is one
+ *
+ * @param pda - The PDA
+ * @param state - The current state
+ * @param stack - The stack, updated in place
+ * @param symbol - The input byte
+ * @return The next state
+ */
+static inline int pdaStep(const Pda *pda, int state, Stack *stack, unsigned char symbol) {
+    PdaMove move = pda->moves[((size_t)state * pda->num_tops + pdaTop(pda, stack)) * PDA_SYMBOLS + symbol];
+
+    if (move.action) {
+        const PdaAction *action = &pda->actions[move.action];
+        if (action->pop)
+            stackPop(stack);
+        for (int i = 0; i < action->push_len; i++)
+            stackPush(stack, action->push[i]);
+    }
+    return move.next;
+}
+
+/*
+ * Check whether a state is a sink
+ *
+ * @param pda - The PDA
+ * @param state - The state to test
+ * @return true if every byte, on every stack top, leads from the state
+ *         back to itself without touching the stack
+ */
+static inline bool pdaIsSink(const Pda *pda, int state) {
+    return pda->loops[state] == (uint32_t)pda->num_tops * PDA_SYMBOLS;
+}
+
+/*
+ * Put a stack into the start configuration
+ *
+ * @param pda - The PDA
+ * @param stack - An initialised stack, emptied (storage kept) and given the
+ *                bottom marker
+ * @return The start state
+ */
+int pdaReset(const Pda *pda, Stack *stack);
+
+/*
+ * Run the PDA over a block of input, stopping early at a sink
+ *
+ * @param pda - The PDA
+ * @param state - The state to start from, receives the final state
+ * @param stack - The stack, updated in place
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t pdaRunUntilSink(const Pda *pda, int *state, Stack *stack, const char *input, size_t len);
+
+/*
+ * Check whether a run ended in an accepting configuration
+ *
+ * @param pda - The PDA
+ * @param state - The final state
+ * @param stack - The final stack
+ * @return true if the state is accepting and the stack is as accept_stack asks
+ */
+bool pdaIsAccepting(const Pda *pda, int state, const Stack *stack);
+
+/*
+ * Build the 0^n 1^(n+1) machine of pda.c and GUI.c
+ *
+ * States keep the S0..S3 numbering of pda.c: S0 counting '0's, S1
+ * matching '1's against them, S2 accept after the extra '1', S3 reject
+ * (sink). The stack holds '0's above a '$' bottom marker.
+ *
+ * @param pda - The PDA to initialise
+ */
+void pdaBuildZerosOnes(Pda *pda);
+
+/*
+ * Vectorized run of the pdaBuildZerosOnes() machine
+ *
+ * The language needs no stack walk at all: a run of '0's, a run of '1's
+ * one longer, and nothing after. Each run is measured 64 bytes at a time
+ * (AVX2 or SSE2 on x86, NEON on AArch64, scalar elsewhere) by comparing
+ * against the expected byte and counting trailing matches in the mask.
+ * Takes and returns the same (state, depth) as pdaCounterRun() on that
+ * machine, so a run can be resumed across chunks and consumed matches too.
+ *
+ * @param state - The state to start from (S0..S3), receives the final state
+ * @param depth - '0's on the stack, updated in place
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless S3 was entered
+ */
+size_t pdaZerosOnesSimd(int *state, uint64_t *depth, const char *input, size_t len);
+
+/*
+ * A PDA whose stack only ever holds copies of one symbol above the
+ * bottom, run with the depth in place of the stack
+ *
+ * @param pda - The PDA it was built from
+ * @param symbol - The counted symbol
+ * @param base - Symbols below the counted ones: 1 with a bottom marker, else 0
+ * @param next - next[(state * 2 + nonzero) * PDA_SYMBOLS + byte]
+ * @param delta - Change in depth on the same move, -1, 0 or +1
+ */
+typedef struct {
+    const Pda *pda;
+    char symbol;
+    int base;
+    uint16_t *next;
+    int8_t *delta;
+} PdaCounter;
+
+/*
+ * Check whether a PDA's stack is really a counter, and tabulate it if so
+ *
+ * Every move is tried once with nothing above the bottom and once with
+ * the counted symbol on top. If each pops or pushes at most one copy of
+ * a single symbol and leaves the bottom alone, the depth is all the
+ * stack ever records, and pdaCounterRun() checks inputs of any length in
+ * constant memory.
+ *
+ * @param pda - The PDA, which must outlive the counter
+ * @param counter - Receives the counter on success
+ * @return true if the PDA can run as a counter
+ */
+bool pdaBuildCounter(const Pda *pda, PdaCounter *counter);
+
+/*
+ * Free the tables of a counter
+ *
+ * @param counter - The counter to free
+ */
+void pdaCounterFree(PdaCounter *counter);
+
+/*
+ * Run a counter over a block of input, stopping early at a sink
+ *
+ * @param counter - The counter
+ * @param state - The state to start from, receives the final state
+ * @param depth - Symbols above the bottom, updated in place
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t pdaCounterRun(const PdaCounter *counter, int *state, uint64_t *depth, const char *input, size_t len);
+
+/*
+ * Check whether a counter run ended in an accepting configuration
+ *
+ * @param counter - The counter
+ * @param state - The final state
+ * @param depth - The final depth
+ * @return true if pdaIsAccepting() would accept the matching stack
+ */
+bool pdaCounterAccepts(const PdaCounter *counter, int state, uint64_t depth);
+
+/*
+ * Stack depth over the course of a run
+ *
+ * Depth after every character is folded into at most PDA_PROFILE_BUCKETS
+ * buckets of bucket_width characters each, keeping the lowest and highest
+ * depth seen in each. When the input outgrows them the width doubles and
+ * neighbouring buckets merge, so any input length fits in fixed space.
+ *
+ * @param max_depth - Deepest the stack got, in symbols above the bottom
+ * @param max_at - Index of the character that first took it there
+ * @param bucket_width - Characters per bucket, a power of two
+ * @param bucket_end - Position where the last bucket in use ends
+ * @param num_buckets - Buckets in use
+ * @param min - Shallowest depth in each bucket
+ * @param max - Deepest depth in each bucket
+ */
+typedef struct {
+    uint64_t max_depth;
+    uint64_t max_at;
+    uint64_t bucket_width;
+    uint64_t bucket_end;
+    int num_buckets;
+    uint64_t min[PDA_PROFILE_BUCKETS];
+    uint64_t max[PDA_PROFILE_BUCKETS];
+} PdaProfile;
+
+/*
+ * Start an empty profile
+ *
+ * @param profile - The profile to initialise
+ */
+void pdaProfileInit(PdaProfile *profile);
+
+/*
+ * Resumable run over input that arrives in pieces
+ *
+ * Holds everything a run carries from one chunk to the next, so a string
+ * can be fed as it is read from a pipe, socket or file, in chunks of any
+ * size, and is never buffered whole. Depth and position are 64-bit
+ * whatever the platform.
+ *
+ * @param pda - The PDA
+ * @param counter - The PDA's counter, or NULL to run on the stack
+ * @param state - Current state
+ * @param depth - Symbols above the bottom marker
+ * @param consumed - Input bytes fed so far, up to the sink if one was entered
+ * @param stack - The stack, unused when running on the counter
+ * @param kernel - Replaces pdaCounterRun() when set, such as
+ *                 pdaZerosOnesSimd(); needs the counter it stands in for
+ * @param profile - Receives the depth after every character when set, at
+ *                  the cost of stepping one character at a time and
+ *                  bypassing the kernel
+ */
+typedef struct {
+    const Pda *pda;
+    const PdaCounter *counter;
+    size_t (*kernel)(int *state, uint64_t *depth, const char *input, size_t len);
+    PdaProfile *profile;
+    int state;
+    uint64_t depth;
+    uint64_t consumed;
+    Stack stack;
+} PdaStream;
+
+/*
+ * Start a run in the start configuration
+ *
+ * @param run - The run to initialise
+ * @param pda - The PDA, which must outlive the run
+ * @param counter - The PDA's counter, or NULL to run on the stack
+ * @param buffer - Storage for the stack until it outgrows it, or NULL
+ * @param buffer_size - Size of buffer in bytes
+ */
+void pdaStreamInit(PdaStream *run, const Pda *pda, const PdaCounter *counter, char *buffer, size_t buffer_size);
+
+/*
+ * Start the next string on the same run
+ *
+ * Keeps the engine and whatever storage the stack has grown, so checking
+ * one string after another allocates nothing once the deepest is past.
+ *
+ * @param run - The run, back in the start configuration
+ */
+void pdaStreamReset(PdaStream *run);
+
+/*
+ * Feed the next chunk of the input string
+ *
+ * @param run - The run
+ * @param chunk - The chunk
+ * @param len - Length of the chunk
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t pdaStreamFeed(PdaStream *run, const char *chunk, size_t len);
+
+/*
+ * Check whether more input can still change the verdict
+ *
+ * @param run - The run
+ * @return true once a sink has been entered
+ */
+static inline bool pdaStreamDone(const PdaStream *run) {
+    return pdaIsSink(run->pda, run->state);
+}
+
+/*
+ * Verdict on the input fed so far
+ *
+ * @param run - The run
+ * @return true if the input so far is accepted
+ */
+bool pdaStreamAccepts(const PdaStream *run);
+
+/*
+ * Free a run's stack
+ *
+ * @param run - The run
+ */
+void pdaStreamFree(PdaStream *run);
+
+#endif
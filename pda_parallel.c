@@ -0,0 +1,132 @@
+#include <stdlib.h>
+
+#include "parallel_chunks.h"
+#include "pda_parallel.h"
+
+#define MERGE_BLOCK 4096 // bytes between lane-convergence checks
+
+/*
+ * One chunk of speculative work
+ *
+ * The first chunk is entered from the real (state, depth) and walked with
+ * pdaCounterRun() instead.
+ *
+ * @param lanes - Where the chunk is and the state of each lane
+ * @param counter - The counter
+ * @param summary - Effect of the chunk so far from each entry state
+ * @param state - First chunk: the entry state, receives the final state
+ * @param depth - First chunk: the entry depth, receives the final depth
+ * @param consumed - First chunk: receives the number of bytes consumed
+ */
+typedef struct {
+    ChunkLanes lanes;
+    const PdaCounter *counter;
+    PdaSummary summary[PDA_PARALLEL_MAX_LANES];
+    int *state;
+    uint64_t *depth;
+    size_t consumed;
+} Chunk;
+
+/*
+ * Walk a block as if the stack were deep, so only nonzero columns are read
+ *
+ * @param counter - The counter
+ * @param state - The state to start from, receives the final state
+ * @param pops - Receives how far below its start the block reads
+ * @param delta - Receives the net change in depth
+ * @param input - The block
+ * @param len - Length of the block
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+static size_t walkDeep(const PdaCounter *counter, int *state, uint64_t *pops, int64_t *delta,
+                       const char *input, size_t len) {
+    const Pda *pda = counter->pda;
+    int s = *state;
+    int64_t d = 0;
+    int64_t need = 0;
+    size_t i = 0;
+
+    while (i < len && !pdaIsSink(pda, s)) {
+        size_t cell = ((size_t)s * 2 + 1) * PDA_SYMBOLS + (unsigned char)input[i++];
+        if (-d > need)
+            need = -d;
+        d += counter->delta[cell];
+        s = counter->next[cell];
+    }
+    *state = s;
+    *pops = (uint64_t)need;
+    *delta = d;
+    return i;
+}
+
+static void *runChunk(void *arg) {
+    Chunk *chunk = arg;
+    ChunkLanes *lanes = &chunk->lanes;
+    const Pda *pda = chunk->counter->pda;
+    uint64_t pops[PDA_PARALLEL_MAX_LANES];
+    int64_t delta[PDA_PARALLEL_MAX_LANES];
+    size_t read[PDA_PARALLEL_MAX_LANES];
+
+    if (chunk->state) {
+        chunk->consumed = pdaCounterRun(chunk->counter, chunk->state, chunk->depth, lanes->input, lanes->len);
+        return NULL;
+    }
+    for (size_t pos = 0; pos < lanes->len; pos += MERGE_BLOCK) {
+        size_t n = lanes->len - pos < MERGE_BLOCK ? lanes->len - pos : MERGE_BLOCK;
+        bool all_sinks = true;
+        for (int i = 0; i < lanes->num_lanes; i++) {
+            read[i] = walkDeep(chunk->counter, &lanes->lane[i], &pops[i], &delta[i], lanes->input + pos, n);
+            all_sinks = all_sinks && pdaIsSink(pda, lanes->lane[i]);
+        }
+        // Append the block to each entry state's summary
+        for (int s = 0; s < pda->num_states; s++) {
+            PdaSummary *sum = &chunk->summary[s];
+            int i = lanes->owner[s];
+            if ((int64_t)pops[i] - sum->delta > (int64_t)sum->pops)
+                sum->pops = (uint64_t)((int64_t)pops[i] - sum->delta);
+            sum->delta += delta[i];
+            sum->consumed += read[i];
+            sum->exit = lanes->lane[i];
+        }
+        parallelMergeLanes(lanes, pda->num_states);
+        if (all_sinks)
+            return NULL; // the rest of the chunk cannot move any lane
+    }
+    return NULL;
+}
+
+size_t pdaRunParallel(const PdaCounter *counter, int *state, uint64_t *depth, const char *input, size_t len, int num_threads) {
+    const Pda *pda = counter->pda;
+    int num_chunks = parallelChunkCount(len, PDA_PARALLEL_MIN_CHUNK, num_threads);
+    if (num_chunks < 2 || pda->num_states > PDA_PARALLEL_MAX_LANES)
+        return pdaCounterRun(counter, state, depth, input, len);
+
+    Chunk *chunks = parallelSplit(input, len, num_chunks, pda->num_states, sizeof(Chunk));
+    for (int t = 0; t < num_chunks; t++) {
+        chunks[t].counter = counter;
+        for (int s = 0; s < pda->num_states; s++) {
+            chunks[t].summary[s].exit = s;
+        }
+    }
+    // the first chunk knows its real entry, no speculation needed
+    chunks[0].state = state;
+    chunks[0].depth = depth;
+    parallelRun(chunks, num_chunks, sizeof(Chunk), runChunk);
+
+    // apply the chunk summaries left to right
+    size_t consumed = chunks[0].consumed;
+    for (int t = 1; t < num_chunks && consumed == (size_t)(chunks[t].lanes.input - input); t++) {
+        const PdaSummary *sum = &chunks[t].summary[*state];
+        if (*depth > sum->pops) {
+            *state = sum->exit;
+            *depth += (uint64_t)sum->delta;
+            consumed += sum->consumed;
+        } else {
+            // the stack reaches the bottom in this chunk, walk it for real
+            consumed += pdaCounterRun(counter, state, depth, chunks[t].lanes.input, chunks[t].lanes.len);
+        }
+    }
+
+    free(chunks);
+    return consumed;
+}
@@ -0,0 +1,55 @@
+#ifndef PDA_PARALLEL_H
+#define PDA_PARALLEL_H
+
+#include "pda_engine.h"
+#include "parallel_chunks.h"
+
+#ifndef PDA_PARALLEL_MIN_CHUNK
+#define PDA_PARALLEL_MIN_CHUNK (1u << 20) // below 1 MiB per thread, stay sequential
+#endif
+#define PDA_PARALLEL_MAX_LANES PARALLEL_MAX_LANES // entry states summarised per chunk
+
+/*
+ * What one chunk does to a counter from one entry state, as long as the
+ * stack never runs down to the bottom inside it
+ *
+ * Summaries compose left to right: (pops1, delta1) then (pops2, delta2)
+ * is (max(pops1, pops2 - delta1), delta1 + delta2).
+ *
+ * @param exit - State after the chunk, or the sink it entered
+ * @param pops - Deepest the chunk reads below its entry depth; the summary
+ *               holds for entry depths above this
+ * @param delta - Net change in depth
+ * @param consumed - Bytes read, the chunk length unless a sink was entered
+ */
+typedef struct {
+    int exit;
+    uint64_t pops;
+    int64_t delta;
+    size_t consumed;
+} PdaSummary;
+
+/*
+ * Multi-threaded run of a counter
+ *
+ * Splits the input into one chunk per thread. Every chunk but the first
+ * is run from all states at once as if the stack were deep, which makes
+ * each move depend on the state and byte alone; lanes that reach the same
+ * state are merged, as in dfaRunParallel(). That gives a PdaSummary per
+ * entry state. The summaries are then applied in order from the real
+ * (state, depth); a chunk entered too shallow for its summary, at most
+ * the one where the stack drains, is walked again with pdaCounterRun().
+ * Falls back to pdaCounterRun() for short inputs or machines with too
+ * many states.
+ *
+ * @param counter - The counter
+ * @param state - The state to start from, receives the final state
+ * @param depth - Symbols above the bottom, updated in place
+ * @param input - The input bytes
+ * @param len - Number of input bytes
+ * @param num_threads - Threads to use, 0 for parallelDefaultThreads()
+ * @return Number of bytes consumed, len unless a sink was entered
+ */
+size_t pdaRunParallel(const PdaCounter *counter, int *state, uint64_t *depth, const char *input, size_t len, int num_threads);
+
+#endif
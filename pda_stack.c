@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pda_stack.h"
+
+void stackInit(Stack *stack, char *buffer, size_t buffer_size) {
+    stack->items = buffer_size > 0 ? buffer : NULL;
+    stack->size = 0;
+    stack->capacity = stack->items ? buffer_size : 0;
+    stack->heap = false;
+}
+
+void stackGrow(Stack *stack) {
+    size_t capacity = stack->capacity ? stack->capacity * 2 : STACK_INITIAL_CAPACITY;
+    char *items;
+
+    if (capacity < stack->capacity) {
+        fprintf(stderr, "Stack overflow.\n");
+        exit(1);
+    }
+    if (stack->heap) {
+        items = realloc(stack->items, capacity);
+    } else {
+        // Leaving the caller's buffer (or no storage at all) for the heap
+        items = malloc(capacity);
+        if (items && stack->size > 0)
+            memcpy(items, stack->items, stack->size);
+    }
+    if (!items) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    stack->items = items;
+    stack->capacity = capacity;
+    stack->heap = true;
+}
+
+void stackFree(Stack *stack) {
+    if (stack->heap)
+        free(stack->items);
+    stackInit(stack, NULL, 0);
+}
@@ -0,0 +1,110 @@
+#ifndef PDA_STACK_H
+#define PDA_STACK_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define STACK_INITIAL_CAPACITY 16 // symbols allocated by the first push
+#define STACK_BOTTOM '$'          // what pop and peek return on an empty stack
+
+/*
+ * Growable symbol stack of the deterministic PDA simulators
+ *
+ * Storage doubles whenever it fills up, so the depth is bounded only by
+ * memory. A stack can start out in a buffer the caller owns (on its own C
+ * stack, say) and moves to the heap only if it outgrows it; a stack
+ * started without one allocates nothing until the first push. Checking
+ * many strings, clear one stack between them with stackClear() rather
+ * than freeing it: after the deepest string so far nothing is allocated.
+ *
+ * @param items - The symbols, bottom first
+ * @param size - Number of symbols on the stack
+ * @param capacity - Number of symbols items can hold
+ * @param heap - true if items was allocated here rather than by the caller
+ */
+typedef struct {
+    char *items;
+    size_t size;
+    size_t capacity;
+    bool heap;
+} Stack;
+
+/*
+ * Initialise an empty stack
+ *
+ * @param stack - The stack to initialise
+ * @param buffer - Storage to use until it is full, or NULL
+ * @param buffer_size - Size of buffer in bytes
+ */
+void stackInit(Stack *stack, char *buffer, size_t buffer_size);
+
+/*
+ * Make room for at least one more symbol
+ *
+ * @param stack - A full stack
+ */
+void stackGrow(Stack *stack);
+
+/*
+ * Free a stack's heap storage and leave it empty
+ *
+ * @param stack - The stack to free
+ */
+void stackFree(Stack *stack);
+
+/*
+ * Empty a stack but keep its storage for the next run
+ *
+ * @param stack - The stack
+ */
+static inline void stackClear(Stack *stack) {
+    stack->size = 0;
+}
+
+/*
+ * Push a symbol onto the stack
+ *
+ * @param stack - The stack
+ * @param symbol - The symbol to push
+ */
+static inline void stackPush(Stack *stack, char symbol) {
+    if (stack->size == stack->capacity)
+        stackGrow(stack);
+    stack->items[stack->size++] = symbol;
+}
+
+/*
+ * Pop a symbol from the stack
+ *
+ * @param stack - The stack
+ * @return The symbol popped, STACK_BOTTOM if the stack was empty
+ */
+static inline char stackPop(Stack *stack) {
+    if (stack->size == 0)
+        return STACK_BOTTOM;
+    return stack->items[--stack->size];
+}
+
+/*
+ * Peek at the top of the stack
+ *
+ * @param stack - The stack
+ * @return The symbol on top, STACK_BOTTOM if the stack is empty
+ */
+static inline char stackPeek(const Stack *stack) {
+    if (stack->size == 0)
+        return STACK_BOTTOM;
+    return stack->items[stack->size - 1];
+}
+
+/*
+ * Check if the stack is empty
+ *
+ * @param stack - The stack
+ * @return true if the stack is empty
+ */
+static inline bool stackIsEmpty(const Stack *stack) {
+    return stack->size == 0;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stack_forest.h"
+
+/*
+ * Slot of the node for (below, symbol), or the free slot it belongs in
+ */
+static size_t findSlot(const StackForest *forest, StackNode below, char symbol) {
+    size_t mask = forest->num_slots - 1;
+    uint64_t hash = ((uint64_t)below << 8 | (unsigned char)symbol) * 0x9e3779b97f4a7c15ull;
+    size_t slot = (size_t)(hash >> 32) & mask;
+
+    for (;;) {
+        StackNode node = forest->slots[slot];
+        if (node == FOREST_EMPTY || (forest->below[node] == below && forest->symbol[node] == symbol))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+/*
+ * Double the node arrays and rebuild the hash table
+ *
+ * @param forest - A full forest
+ */
+static void forestGrow(StackForest *forest) {
+    uint32_t capacity = forest->capacity ? forest->capacity * 2 : FOREST_INITIAL_CAPACITY;
+
+    if (capacity < forest->capacity) {
+        fprintf(stderr, "Stack overflow.\n");
+        exit(1);
+    }
+    char *symbol = realloc(forest->symbol, capacity);
+    StackNode *below = realloc(forest->below, (size_t)capacity * sizeof(StackNode));
+    StackNode *slots = calloc((size_t)capacity * 2, sizeof(StackNode));
+    if (!symbol || !below || !slots) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    free(forest->slots);
+    forest->symbol = symbol;
+    forest->below = below;
+    forest->capacity = capacity;
+    forest->slots = slots;
+    forest->num_slots = (size_t)capacity * 2;
+    if (forest->count == 0) {
+        // Node 0 is the empty stack, never looked up
+        forest->symbol[0] = STACK_BOTTOM;
+        forest->below[0] = FOREST_EMPTY;
+        forest->count = 1;
+    }
+    for (StackNode node = 1; node < forest->count; node++) {
+        forest->slots[findSlot(forest, forest->below[node], forest->symbol[node])] = node;
+    }
+}
+
+void forestInit(StackForest *forest) {
+    forest->symbol = NULL;
+    forest->below = NULL;
+    forest->count = 0;
+    forest->capacity = 0;
+    forest->slots = NULL;
+    forest->num_slots = 0;
+}
+
+void forestFree(StackForest *forest) {
+    free(forest->symbol);
+    free(forest->below);
+    free(forest->slots);
+    forestInit(forest);
+}
+
+StackNode forestPush(StackForest *forest, StackNode top, char symbol) {
+    if (forest->count == forest->capacity)
+        forestGrow(forest);
+
+    size_t slot = findSlot(forest, top, symbol);
+    if (forest->slots[slot] == FOREST_EMPTY) {
+        StackNode node = forest->count++;
+        forest->symbol[node] = symbol;
+        forest->below[node] = top;
+        forest->slots[slot] = node;
+    }
+    return forest->slots[slot];
+}
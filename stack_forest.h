@@ -0,0 +1,93 @@
+#ifndef STACK_FOREST_H
+#define STACK_FOREST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pda_stack.h"
+
+#define FOREST_INITIAL_CAPACITY 64 // nodes allocated by the first push
+#define FOREST_EMPTY 0             // the empty stack
+
+/*
+ * A stack in a forest: the node of its top symbol, FOREST_EMPTY if none
+ */
+typedef uint32_t StackNode;
+
+/*
+ * Graph-structured stacks shared by all paths of one NPDA run
+ *
+ * Every node holds one symbol and the node below it, so a stack is just
+ * the index of its top node and stacks share their common lower parts.
+ * Push adds at most one node and pop and fork copy nothing: each is O(1).
+ * Nodes are hash-consed, so pushing the same symbol onto the same stack
+ * twice gives back the same node; two stacks hold the same symbols
+ * exactly when their top nodes are equal. Nodes live until the forest is
+ * freed at the end of the run.
+ *
+ * @param symbol - Symbol of each node; node 0 stands for the empty stack
+ * @param below - Node under each node
+ * @param count - Nodes in use, node 0 included
+ * @param capacity - Nodes symbol and below can hold
+ * @param slots - Open-addressing hash table of nodes by (below, symbol),
+ *                0 for a free slot
+ * @param num_slots - Size of slots, twice capacity (a power of two)
+ */
+typedef struct {
+    char *symbol;
+    StackNode *below;
+    uint32_t count;
+    uint32_t capacity;
+    StackNode *slots;
+    size_t num_slots;
+} StackForest;
+
+/*
+ * Initialise a forest holding only the empty stack; nothing is allocated
+ * until the first push
+ *
+ * @param forest - The forest to initialise
+ */
+void forestInit(StackForest *forest);
+
+/*
+ * Free every node of a forest
+ *
+ * @param forest - The forest to free
+ */
+void forestFree(StackForest *forest);
+
+/*
+ * Push a symbol onto a stack
+ *
+ * @param forest - The forest
+ * @param top - The stack
+ * @param symbol - The symbol to push
+ * @return The stack with the symbol on top; top itself is unchanged
+ */
+StackNode forestPush(StackForest *forest, StackNode top, char symbol);
+
+/*
+ * Pop a symbol from a stack
+ *
+ * @param forest - The forest
+ * @param top - The stack
+ * @return The stack without its top symbol, FOREST_EMPTY if it was empty
+ */
+static inline StackNode forestPop(const StackForest *forest, StackNode top) {
+    return top == FOREST_EMPTY ? FOREST_EMPTY : forest->below[top];
+}
+
+/*
+ * Peek at the top of a stack
+ *
+ * @param forest - The forest
+ * @param top - The stack
+ * @return The symbol on top, STACK_BOTTOM if the stack is empty
+ */
+static inline char forestPeek(const StackForest *forest, StackNode top) {
+    return top == FOREST_EMPTY ? STACK_BOTTOM : forest->symbol[top];
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "pda_engine.h"
+#include "pda_parallel.h"
+
+// The build lowers PDA_PARALLEL_MIN_CHUNK for this check, so short strings
+// are split across threads
+#define THREADS 4
+
+/*
+ * Run one string through pdaRunParallel() and pdaCounterRun() and compare
+ *
+ * @param counter - The counter
+ * @param start - The state to start from
+ * @param input - The string
+ * @param len - Length of the string
+ * @return 0 if both ended alike, 1 otherwise
+ */
+static int checkString(const PdaCounter *counter, int start, const char *input, size_t len) {
+    int seqState = start, parState = start;
+    uint64_t seqDepth = 0, parDepth = 0;
+    size_t seqRead = pdaCounterRun(counter, &seqState, &seqDepth, input, len);
+    size_t parRead = pdaRunParallel(counter, &parState, &parDepth, input, len, THREADS);
+    if (parState == seqState && parDepth == seqDepth && parRead == seqRead)
+        return 0;
+    printf("FAIL %zu characters: counter ended in S%d at depth %" PRIu64 " after %zu, "
+        "parallel in S%d at depth %" PRIu64 " after %zu\n",
+        len, seqState, seqDepth, seqRead, parState, parDepth, parRead);
+    return 1;
+}
+
+int main(void) {
+    Pda machine;
+    PdaCounter counter;
+    int failures = 0;
+
+    pdaBuildZerosOnes(&machine);
+    if (!pdaBuildCounter(&machine, &counter)) {
+        printf("FAIL built-in machine has no counter\n");
+        return 1;
+    }
+
+    // For strings long enough to split: an accepted one, one a '1' short,
+    // and one with a '0' among the '1's
+    size_t max_zeros = 8 * (size_t)PDA_PARALLEL_MIN_CHUNK;
+    char *input = malloc(2 * max_zeros + 1);
+    if (!input) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    size_t step = PDA_PARALLEL_MIN_CHUNK / 16 + 3; // odd steps move the chunk borders around
+    int checked = 0;
+    for (size_t zeros = PDA_PARALLEL_MIN_CHUNK; zeros <= max_zeros; zeros += step) {
+        for (int variant = 0; variant < 3; variant++) {
+            memset(input, '0', zeros);
+            memset(input + zeros, '1', zeros + 1);
+            size_t len = variant == 1 ? 2 * zeros : 2 * zeros + 1;
+            if (variant == 2)
+                input[len - 2] = '0';
+            failures += checkString(&counter, machine.start, input, len);
+            checked++;
+        }
+    }
+    free(input);
+    pdaCounterFree(&counter);
+    pdaFree(&machine);
+
+    printf("%s   %d strings, %d mismatches\n", failures ? "FAIL" : "ok", checked, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dfa_regex.h"
+
+/*
+ * Check that patterns too long for the NFA limit are refused, not crashed on
+ *
+ * @param name - What the pattern is
+ * @param unit - Text the pattern repeats
+ * @param separator - Text between repeats
+ * @return 0 if the pattern was refused, 1 if it compiled
+ */
+static int checkLongPattern(const char *name, const char *unit, const char *separator) {
+    size_t step = strlen(unit) + strlen(separator);
+    size_t count = REGEX_MAX_NFA_STATES;
+    char *pattern = malloc(count * step + 1);
+    char error[256];
+    Dfa table;
+    if (!pattern) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        memcpy(pattern + i * step, unit, strlen(unit));
+        memcpy(pattern + i * step + strlen(unit), separator, strlen(separator));
+    }
+    pattern[count * step - strlen(separator)] = '\0';
+
+    int failed = regexCompile(pattern, &table, error, sizeof(error)) == 0;
+    if (failed) {
+        printf("FAIL %s: %zu characters compiled\n", name, strlen(pattern));
+        dfaFree(&table);
+    } else {
+        printf("ok   %s: %s\n", name, error);
+    }
+    free(pattern);
+    return failed;
+}
+
+int main(void) {
+    int failures = 0;
+    failures += checkLongPattern("long concatenation", "a", "");
+    failures += checkLongPattern("long alternation", "a", "|");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "automaton_spec.h"
+
+#define NPDA_HEADER \
+    "type npda\n" \
+    "states A B C\n" \
+    "alphabet 0\n" \
+    "stack 0\n" \
+    "start A\n" \
+    "accept C\n" \
+    "A 0 * -> C\n"
+
+/*
+ * Parse a description and compare the outcome with what is expected
+ *
+ * @param name - What the description is
+ * @param text - The description
+ * @param valid - Whether it should parse
+ * @return 0 if it did as expected, 1 otherwise
+ */
+static int checkSpec(const char *name, const char *text, bool valid) {
+    AutomatonSpec spec;
+    char error[256] = "";
+    bool parsed = specParse(&spec, text, error, sizeof(error)) == 0;
+    if (parsed)
+        specFree(&spec);
+    printf("%s %s: %s\n", parsed == valid ? "ok  " : "FAIL", name, parsed ? "parsed" : error);
+    return parsed != valid;
+}
+
+int main(void) {
+    int failures = 0;
+
+    // Epsilon cycles that push without end would never finish a run
+    failures += checkSpec("pushing epsilon loop", NPDA_HEADER
+        "A - * -> A push 0\n", false);
+    failures += checkSpec("pushing epsilon cycle", NPDA_HEADER
+        "A - * -> B push 00\n"
+        "B - * -> A pop\n", false);
+    failures += checkSpec("cycle pushing after a replace", NPDA_HEADER
+        "A - * -> B pop push 0\n"
+        "B - 0 -> A push 0\n", false);
+
+    // Cycles that give back what they push end on their own
+    failures += checkSpec("balanced epsilon cycle", NPDA_HEADER
+        "A - * -> B push 0\n"
+        "B - * -> A pop\n", true);
+    failures += checkSpec("replacing epsilon loop", NPDA_HEADER
+        "A - * -> A pop push 0\n", true);
+    failures += checkSpec("pushing epsilon path", NPDA_HEADER
+        "A - * -> B push 00\n"
+        "B - * -> C push 0\n", true);
+
+    return failures ? 1 : 0;
+}